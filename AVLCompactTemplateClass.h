@@ -0,0 +1,821 @@
+/*
+@filename: AVL Compact Search Tree Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the CompactBinarySearchTree class, an alternative storage layout for the AVL search tree. Nodes live in one contiguous vector
+and link to each other with 32-bit indices instead of pointers, and each node keeps a 2-bit balance factor packed beside its parent index in place of a full
+height. For an int key a node takes 16 bytes rather than the 32 bytes of a BinaryTreeNode, so more of each search path fits in cache.
+
+The public functions match those of BinarySearchTree, so either tree can be swapped for the other. Removing an item moves the last node of the vector into the
+freed slot to keep the storage dense, so any removal invalidates iterators and references, not just those to the removed item. Order statistics and the
+rotation test hooks are only offered by BinarySearchTree.
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include <cstdint>
+#include <utility>
+
+/*
+Compact binary search tree class holds the nodes of an AVL tree in a vector, linked by index. The balance factor of each node is the height of its right subtree
+minus the height of its left subtree, which an AVL tree keeps within -1 to 1, so two bits are enough to store it.
+
+@param[in]: The DATA_TYPE of the items, the compare policy, and the allocator, which is rebound for the node vector.
+@return: A tree object using the compact node layout.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>, typename Allocator = allocator<DATA_TYPE>>
+class CompactBinarySearchTree
+{
+    //Index used for a missing child, parent, or root. The parent index shares its word with the balance factor, so indices have 30 bits.
+    static constexpr uint32_t NO_NODE = 0x3FFFFFFF;
+    static constexpr uint32_t PARENT_MASK = 0x3FFFFFFF;
+    static constexpr int BALANCE_SHIFT = 30;
+
+    /*
+    Compact tree node struct holds the value of a node, the indices of its children, and its parent index with the balance factor, stored plus one, in the top
+    two bits.
+    */
+    struct CompactTreeNode
+    {
+        DATA_TYPE nodeValue;
+        uint32_t leftChild;
+        uint32_t rightChild;
+        uint32_t parentAndBalance;
+
+        template <typename... ARGS>
+        CompactTreeNode(in_place_t, ARGS&&... args) : nodeValue(std::forward<ARGS>(args)...), leftChild(NO_NODE), rightChild(NO_NODE), parentAndBalance(NO_NODE | (1u << BALANCE_SHIFT)) {}
+    };
+
+    using NodeAllocator = typename allocator_traits<Allocator>::template rebind_alloc<CompactTreeNode>;
+
+    vector<CompactTreeNode, NodeAllocator> nodes;
+    uint32_t root;
+    Compare compare;
+
+    //Accessors for the packed parent index and balance factor.
+    uint32_t parentOf(uint32_t node) const
+    {
+        return nodes[node].parentAndBalance & PARENT_MASK;
+    }
+    void setParent(uint32_t node, uint32_t parent)
+    {
+        nodes[node].parentAndBalance = (nodes[node].parentAndBalance & ~PARENT_MASK) | parent;
+    }
+    int balanceOf(uint32_t node) const
+    {
+        return (int)(nodes[node].parentAndBalance >> BALANCE_SHIFT) - 1;
+    }
+    void setBalance(uint32_t node, int balance)
+    {
+        nodes[node].parentAndBalance = (nodes[node].parentAndBalance & PARENT_MASK) | ((uint32_t)(balance + 1) << BALANCE_SHIFT);
+    }
+
+    //Private function declarations.
+    template <typename KEY>
+    uint32_t findParentOrDuplicate(const KEY& item, int& lastComparison) const;
+    template <typename KEY>
+    uint32_t findNode(const KEY& item) const
+    {
+        int lastComparison;
+        uint32_t searchResult = findParentOrDuplicate(item, lastComparison);
+        return searchResult != NO_NODE && !lastComparison ? searchResult : NO_NODE;
+    }
+    template <typename KEY>
+    uint32_t lowerBoundNode(const KEY& item) const
+    {
+        int lastComparison;
+        uint32_t searchResult = findParentOrDuplicate(item, lastComparison);
+        if (searchResult != NO_NODE && lastComparison < 0)
+            searchResult = successorNode(searchResult);
+        return searchResult;
+    }
+    template <typename KEY>
+    uint32_t upperBoundNode(const KEY& item) const
+    {
+        int lastComparison;
+        uint32_t searchResult = findParentOrDuplicate(item, lastComparison);
+        if (searchResult != NO_NODE && lastComparison <= 0)
+            searchResult = successorNode(searchResult);
+        return searchResult;
+    }
+    void attachNode(uint32_t parent, uint32_t node, int lastComparison);
+    void removeNode(uint32_t node);
+    void releaseSlot(uint32_t node);
+    uint32_t buildBalanced(uint32_t first, uint32_t count, uint32_t parent);
+    void replaceChild(uint32_t parent, uint32_t oldChild, uint32_t newChild);
+    void rotateLeft(uint32_t node);
+    void rotateRight(uint32_t node);
+    uint32_t rebalanceRightHeavy(uint32_t node, bool& heightChanged);
+    uint32_t rebalanceLeftHeavy(uint32_t node, bool& heightChanged);
+
+    /*
+    Leftmost, rightmost, successor, and predecessor functions walk the index links the same way the pointer tree walks its node pointers.
+
+    @param[in]: A node index, which must not be NO_NODE.
+    @return: The index of the requested node, or NO_NODE when there is none.
+    */
+    uint32_t leftmostNode(uint32_t node) const
+    {
+        while (nodes[node].leftChild != NO_NODE)
+            node = nodes[node].leftChild;
+        return node;
+    }
+    uint32_t rightmostNode(uint32_t node) const
+    {
+        while (nodes[node].rightChild != NO_NODE)
+            node = nodes[node].rightChild;
+        return node;
+    }
+    uint32_t successorNode(uint32_t node) const
+    {
+        if (nodes[node].rightChild != NO_NODE)
+            return leftmostNode(nodes[node].rightChild);
+        uint32_t parent = parentOf(node);
+        while (parent != NO_NODE && nodes[parent].rightChild == node)
+        {
+            node = parent;
+            parent = parentOf(node);
+        }
+        return parent;
+    }
+    uint32_t predecessorNode(uint32_t node) const
+    {
+        if (nodes[node].leftChild != NO_NODE)
+            return rightmostNode(nodes[node].leftChild);
+        uint32_t parent = parentOf(node);
+        while (parent != NO_NODE && nodes[parent].leftChild == node)
+        {
+            node = parent;
+            parent = parentOf(node);
+        }
+        return parent;
+    }
+
+public:
+    /*
+    Iterator class walks the values of the tree in ascending order through the index links, like the BinarySearchTree iterator. Removing any item invalidates
+    all iterators, since the last node is moved into the freed slot.
+    */
+    class Iterator
+    {
+        const CompactBinarySearchTree* tree;
+        uint32_t node;
+
+        friend class CompactBinarySearchTree;
+        Iterator(const CompactBinarySearchTree* owner, uint32_t position) : tree(owner), node(position) {}
+
+    public:
+        using iterator_category = bidirectional_iterator_tag;
+        using value_type = DATA_TYPE;
+        using difference_type = ptrdiff_t;
+        using pointer = const DATA_TYPE*;
+        using reference = const DATA_TYPE&;
+
+        Iterator() : tree(nullptr), node(NO_NODE) {}
+
+        reference operator*() const
+        {
+            return tree->nodes[node].nodeValue;
+        }
+        pointer operator->() const
+        {
+            return &tree->nodes[node].nodeValue;
+        }
+        Iterator& operator++()
+        {
+            node = tree->successorNode(node);
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+        Iterator& operator--()
+        {
+            node = node != NO_NODE ? tree->predecessorNode(node) : tree->rightmostNode(tree->root);
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator previous = *this;
+            --(*this);
+            return previous;
+        }
+        bool operator==(const Iterator& other) const
+        {
+            return node == other.node;
+        }
+        bool operator!=(const Iterator& other) const
+        {
+            return node != other.node;
+        }
+    };
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+    using reverse_iterator = std::reverse_iterator<Iterator>;
+    using const_reverse_iterator = std::reverse_iterator<Iterator>;
+
+    //Public function declarations, and definitions for simple functions.
+    CompactBinarySearchTree(Compare cmp = defaultCompare<Compare>(), const Allocator& alloc = Allocator()) : nodes(NodeAllocator(alloc)), root(NO_NODE), compare(cmp) {}
+    template <typename ITERATOR>
+    CompactBinarySearchTree(ITERATOR first, ITERATOR last, bool sortAndDeduplicate = false, Compare cmp = defaultCompare<Compare>(), const Allocator& alloc = Allocator())
+        : nodes(NodeAllocator(alloc)), root(NO_NODE), compare(cmp)
+    {
+        assignSorted(first, last, sortAndDeduplicate);
+    }
+    /*
+    Clear function empties the tree. The node vector keeps its capacity for reuse, and reserve sets aside room for a number of nodes up front.
+
+    @param[in]: For reserve, the number of nodes to make room for.
+    @return: An empty tree, or a tree that can grow to that size without reallocating.
+    */
+    void clear()
+    {
+        nodes.clear();
+        root = NO_NODE;
+    }
+    void reserve(size_t nodeCount)
+    {
+        nodes.reserve(nodeCount);
+    }
+
+    template <typename ITERATOR>
+    void assignSorted(ITERATOR first, ITERATOR last, bool sortAndDeduplicate = false);
+
+    void insert(const DATA_TYPE& item);
+    void insert(DATA_TYPE&& item);
+    void remove(const DATA_TYPE& item);
+    const DATA_TYPE& search(const DATA_TYPE& item) const;
+    pair<Iterator, bool> tryInsert(const DATA_TYPE& item)
+    {
+        return tryEmplace(item, item);
+    }
+    pair<Iterator, bool> tryInsert(DATA_TYPE&& item)
+    {
+        return tryEmplace(item, std::move(item));
+    }
+    template <typename... ARGS>
+    pair<Iterator, bool> emplace(ARGS&&... args);
+    template <typename KEY, typename... ARGS>
+    pair<Iterator, bool> tryEmplace(const KEY& key, ARGS&&... args);
+    /*
+    Count function returns the number of nodes in the tree.
+
+    @param[in]: Nothing.
+    @return: The current number of nodes in a tree.
+    */
+    int count() const
+    {
+        return (int)nodes.size();
+    }
+    /*
+    Find, try remove, lower bound, and upper bound functions behave as they do in BinarySearchTree, including the overloads taking a key of another type when the
+    compare policy declares is_transparent.
+
+    @param[in]: An item, or a key the compare policy can compare against stored values.
+    @return: A pointer to the value or null, whether anything was removed, or an iterator at the bound or end.
+    */
+    const DATA_TYPE* find(const DATA_TYPE& item) const
+    {
+        uint32_t node = findNode(item);
+        return node != NO_NODE ? &nodes[node].nodeValue : nullptr;
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    const DATA_TYPE* find(const KEY& key) const
+    {
+        uint32_t node = findNode(key);
+        return node != NO_NODE ? &nodes[node].nodeValue : nullptr;
+    }
+    bool tryRemove(const DATA_TYPE& item)
+    {
+        uint32_t node = findNode(item);
+        if (node != NO_NODE)
+            removeNode(node);
+        return node != NO_NODE;
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    bool tryRemove(const KEY& key)
+    {
+        uint32_t node = findNode(key);
+        if (node != NO_NODE)
+            removeNode(node);
+        return node != NO_NODE;
+    }
+    Iterator lowerBound(const DATA_TYPE& item) const
+    {
+        return Iterator(this, lowerBoundNode(item));
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    Iterator lowerBound(const KEY& key) const
+    {
+        return Iterator(this, lowerBoundNode(key));
+    }
+    Iterator upperBound(const DATA_TYPE& item) const
+    {
+        return Iterator(this, upperBoundNode(item));
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    Iterator upperBound(const KEY& key) const
+    {
+        return Iterator(this, upperBoundNode(key));
+    }
+    pair<Iterator, Iterator> equalRange(const DATA_TYPE& item) const
+    {
+        Iterator first = lowerBound(item);
+        Iterator last = first;
+        if (last != end() && compare(*last, item) == 0)
+            ++last;
+        return make_pair(first, last);
+    }
+    template <typename VISIT>
+    void forEachInRange(const DATA_TYPE& low, const DATA_TYPE& high, VISIT visit) const
+    {
+        for (Iterator current = lowerBound(low); current != end() && compare(*current, high) <= 0; ++current)
+            visit(*current);
+    }
+    FrozenSearchTree<DATA_TYPE, Compare> freeze() const;
+    template <typename VISIT>
+    void inOrder(VISIT visit) const
+    {
+        for (const DATA_TYPE& item : *this)
+            visit(item);
+    }
+    /*
+    Begin and end functions return iterators to the smallest value and one past the largest value, and rbegin and rend do the same for the reverse order.
+
+    @param[in]: Nothing.
+    @return: An iterator at the requested position.
+    */
+    Iterator begin() const
+    {
+        return Iterator(this, root != NO_NODE ? leftmostNode(root) : NO_NODE);
+    }
+    Iterator end() const
+    {
+        return Iterator(this, NO_NODE);
+    }
+    reverse_iterator rbegin() const
+    {
+        return reverse_iterator(end());
+    }
+    reverse_iterator rend() const
+    {
+        return reverse_iterator(begin());
+    }
+    /*
+    Return height function finds a node and returns its height. Heights are not stored, so it follows the taller child at each level, which the balance factors
+    identify, down to a leaf.
+
+    @param[in]: Value of the node being searched for for its height.
+    @return: The height of the node searched for.
+    */
+    int returnHeight(const DATA_TYPE& item) const
+    {
+        int height = 0;
+        for (uint32_t node = findNode(item); node != NO_NODE; height++)
+            node = balanceOf(node) < 0 ? nodes[node].leftChild : nodes[node].rightChild;
+        return height;
+    }
+    /*
+    Bytes per node function reports the size of one node in the vector, for comparing the layout against BinaryTreeNode.
+
+    @param[in]: Nothing.
+    @return: The size of a node in bytes.
+    */
+    static constexpr size_t bytesPerNode()
+    {
+        return sizeof(CompactTreeNode);
+    }
+};
+/*
+Assign sorted function replaces the contents of the tree with the items of a range in linear time, following the rules of BinarySearchTree::assignSorted. The
+values are stored in ascending order, so neighbouring values also sit next to each other in memory, and then linked into a balanced tree.
+
+@param[in]: A range of forward iterators over the items, and whether the range must first be sorted and deduplicated.
+@return: The tree holding exactly the items of the range. An unsorted or duplicated range throws and leaves the tree unchanged.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+template <typename ITERATOR>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::assignSorted(ITERATOR first, ITERATOR last, bool sortAndDeduplicate)
+{
+    if (sortAndDeduplicate)
+    {
+        vector<DATA_TYPE> items(first, last);
+        sort(items.begin(), items.end(), [this](const DATA_TYPE& item1, const DATA_TYPE& item2) { return compare(item1, item2) < 0; });
+        items.erase(unique(items.begin(), items.end(), [this](const DATA_TYPE& item1, const DATA_TYPE& item2) { return compare(item1, item2) == 0; }), items.end());
+        assignSorted(make_move_iterator(items.begin()), make_move_iterator(items.end()));
+        return;
+    }
+
+    size_t itemCount = 0;
+    if (first != last)
+    {
+        itemCount = 1;
+        ITERATOR previous = first;
+        for (ITERATOR current = std::next(first); current != last; ++current, ++previous, itemCount++)
+        {
+            int result = compare(*previous, *current);
+            if (result == 0)
+                throw DuplicateItemException(__LINE__, "Duplicate item detected. Unable to bulk load");
+            if (result > 0)
+                throw UnsortedInputException(__LINE__, "Items are not in ascending order. Unable to bulk load");
+        }
+    }
+    if (itemCount >= NO_NODE)
+        throw Exception(__LINE__, "Too many items for 32-bit node indices. Unable to bulk load");
+
+    vector<CompactTreeNode, NodeAllocator> newNodes(nodes.get_allocator());
+    newNodes.reserve(itemCount);
+    for (; first != last; ++first)
+        newNodes.emplace_back(in_place, *first);
+    nodes.swap(newNodes);
+    root = buildBalanced(0, (uint32_t)itemCount, NO_NODE);
+}
+/*
+Build balanced function links the stored nodes first to first + count - 1 into a balanced subtree, with the middle node as its root. The left half is never
+smaller than the right half, so each balance factor is 0 or -1, found from the heights of the two halves.
+
+@param[in]: The first node of the subtree, the number of nodes in it, and the parent of its root.
+@return: The index of the root of the subtree, or NO_NODE for an empty subtree.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+uint32_t CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::buildBalanced(uint32_t first, uint32_t count, uint32_t parent)
+{
+    if (count == 0)
+        return NO_NODE;
+
+    auto heightOf = [](uint32_t size) {
+        int height = 0;
+        for (; size; size >>= 1)
+            height++;
+        return height;
+    };
+    uint32_t leftCount = count / 2;
+    uint32_t rightCount = count - leftCount - 1;
+    uint32_t node = first + leftCount;
+    nodes[node].leftChild = buildBalanced(first, leftCount, node);
+    nodes[node].rightChild = buildBalanced(node + 1, rightCount, node);
+    setParent(node, parent);
+    setBalance(node, heightOf(rightCount) - heightOf(leftCount));
+    return node;
+}
+
+/*
+Insert functions add an item using tryInsert, and throw an exception if the item already exists.
+
+@param[in]: An item to store in a new node.
+@return: The tree with the new node, potentially rebalanced.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::insert(const DATA_TYPE& item)
+{
+    if (!tryInsert(item).second)
+        throw DuplicateItemException(__LINE__, "Duplicate item detected. Unable to insert");
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::insert(DATA_TYPE&& item)
+{
+    if (!tryInsert(std::move(item)).second)
+        throw DuplicateItemException(__LINE__, "Duplicate item detected. Unable to insert");
+}
+/*
+Emplace function constructs a value at the end of the node vector from the arguments, then links it in if no equal value exists. A duplicate is removed from the
+end of the vector again, as is the value when a comparison throws, so it never leaves a hole.
+
+@param[in]: The arguments for the constructor of the value.
+@return: An iterator at the new value or at the existing equal value, and whether the value was inserted.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+template <typename... ARGS>
+pair<typename CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::Iterator, bool> CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::emplace(ARGS&&... args)
+{
+    if (nodes.size() >= NO_NODE)
+        throw Exception(__LINE__, "Too many items for 32-bit node indices. Unable to insert");
+
+    nodes.emplace_back(in_place, std::forward<ARGS>(args)...);
+    uint32_t node = (uint32_t)nodes.size() - 1;
+    int lastComparison;
+    uint32_t searchNode;
+    try
+    {
+        searchNode = findParentOrDuplicate(nodes[node].nodeValue, lastComparison);
+    }
+    catch (...)
+    {
+        nodes.pop_back();
+        throw;
+    }
+    if (searchNode != NO_NODE && !lastComparison)
+    {
+        nodes.pop_back();
+        return make_pair(Iterator(this, searchNode), false);
+    }
+
+    attachNode(searchNode, node, lastComparison);
+    return make_pair(Iterator(this, node), true);
+}
+/*
+Try emplace function looks up a key first, and only constructs a value from the arguments when the key is missing, so a duplicate costs a single descent.
+
+@param[in]: The key to look up, and the arguments for the constructor of the value.
+@return: An iterator at the new value or at the existing equal value, and whether the value was inserted.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+template <typename KEY, typename... ARGS>
+pair<typename CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::Iterator, bool> CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::tryEmplace(const KEY& key, ARGS&&... args)
+{
+    int lastComparison;
+    uint32_t searchNode = findParentOrDuplicate(key, lastComparison);
+    if (searchNode != NO_NODE && !lastComparison)
+        return make_pair(Iterator(this, searchNode), false);
+    if (nodes.size() >= NO_NODE)
+        throw Exception(__LINE__, "Too many items for 32-bit node indices. Unable to insert");
+
+    nodes.emplace_back(in_place, std::forward<ARGS>(args)...);
+    uint32_t node = (uint32_t)nodes.size() - 1;
+    attachNode(searchNode, node, lastComparison);
+    return make_pair(Iterator(this, node), true);
+}
+/*
+Attach node function links a new node below the parent found for it, or at the root if the tree is empty, then walks back up updating balance factors. The walk
+stops at the first node whose balance returns to 0, since its height did not change, or after the single or double rotation that an imbalance of 2 needs, since
+that restores the height the subtree had before the insert.
+
+@param[in]: The parent found by findParentOrDuplicate, NO_NODE for an empty tree, the new unlinked node, and the last comparison result of the descent.
+@return: The tree with the new node, potentially rebalanced.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::attachNode(uint32_t parent, uint32_t node, int lastComparison)
+{
+    if (parent == NO_NODE)
+    {
+        root = node;
+        return;
+    }
+    if (lastComparison > 0)
+        nodes[parent].leftChild = node;
+    else
+        nodes[parent].rightChild = node;
+    setParent(node, parent);
+
+    while (parent != NO_NODE)
+    {
+        int balance = balanceOf(parent) + (nodes[parent].leftChild == node ? -1 : 1);
+        if (balance == 0)
+        {
+            setBalance(parent, 0);
+            return;
+        }
+        if (balance == 2 || balance == -2)
+        {
+            bool heightChanged;
+            if (balance == 2)
+                rebalanceRightHeavy(parent, heightChanged);
+            else
+                rebalanceLeftHeavy(parent, heightChanged);
+            return;
+        }
+        setBalance(parent, balance);
+        node = parent;
+        parent = parentOf(parent);
+    }
+}
+
+/*
+Remove function deletes an item using tryRemove, and throws an exception if the item was not found.
+
+@param[in]: The item to delete out of the tree.
+@return: The tree without the item, potentially rebalanced.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::remove(const DATA_TYPE& item)
+{
+    if (!tryRemove(item))
+        throw ItemNotFoundException(__LINE__, "Item was not found");
+}
+/*
+Remove node function unlinks a node and walks back up the tree updating balance factors. A node with two children takes the value of its in-order predecessor,
+and the predecessor node, which has at most one child, is unlinked instead. The walk stops once a subtree keeps its height, either because a balance factor went
+from 0 to 1 or -1, or because a rotation left the subtree as tall as before. Finally the slot of the unlinked node is released.
+
+@param[in]: The index of the node to delete out of the tree.
+@return: The tree without the node, potentially rebalanced.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::removeNode(uint32_t node)
+{
+    if (nodes[node].leftChild != NO_NODE && nodes[node].rightChild != NO_NODE)
+    {
+        uint32_t predecessor = rightmostNode(nodes[node].leftChild);
+        nodes[node].nodeValue = std::move(nodes[predecessor].nodeValue);
+        node = predecessor;
+    }
+
+    uint32_t child = nodes[node].leftChild != NO_NODE ? nodes[node].leftChild : nodes[node].rightChild;
+    uint32_t parent = parentOf(node);
+    bool leftShrank = parent != NO_NODE && nodes[parent].leftChild == node;
+    replaceChild(parent, node, child);
+    if (child != NO_NODE)
+        setParent(child, parent);
+
+    while (parent != NO_NODE)
+    {
+        int balance = balanceOf(parent) + (leftShrank ? 1 : -1);
+        uint32_t subtreeRoot = parent;
+        if (balance == 1 || balance == -1)
+        {
+            setBalance(parent, balance);
+            break;
+        }
+        if (balance == 0)
+        {
+            setBalance(parent, 0);
+        }
+        else
+        {
+            bool heightChanged;
+            subtreeRoot = balance == 2 ? rebalanceRightHeavy(parent, heightChanged) : rebalanceLeftHeavy(parent, heightChanged);
+            if (!heightChanged)
+                break;
+        }
+        parent = parentOf(subtreeRoot);
+        leftShrank = parent != NO_NODE && nodes[parent].leftChild == subtreeRoot;
+    }
+
+    releaseSlot(node);
+}
+/*
+Release slot function frees the vector slot of an unlinked node by moving the last node of the vector into it and fixing the links that pointed at the last node,
+then shrinking the vector by one.
+
+@param[in]: The index of a node that is no longer linked into the tree.
+@return: The node vector one shorter, with no holes.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::releaseSlot(uint32_t node)
+{
+    uint32_t last = (uint32_t)nodes.size() - 1;
+    if (node != last)
+    {
+        nodes[node] = std::move(nodes[last]);
+        replaceChild(parentOf(node), last, node);
+        if (nodes[node].leftChild != NO_NODE)
+            setParent(nodes[node].leftChild, node);
+        if (nodes[node].rightChild != NO_NODE)
+            setParent(nodes[node].rightChild, node);
+    }
+    nodes.pop_back();
+}
+/*
+Replace child function points the parent of a subtree at a new child in place of the old one, or makes the new child the root when there is no parent.
+
+@param[in]: The parent, or NO_NODE for the root, the old child, and the new child.
+@return: The parent linked to the new child.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::replaceChild(uint32_t parent, uint32_t oldChild, uint32_t newChild)
+{
+    if (parent == NO_NODE)
+        root = newChild;
+    else if (nodes[parent].leftChild == oldChild)
+        nodes[parent].leftChild = newChild;
+    else
+        nodes[parent].rightChild = newChild;
+}
+/*
+Rebalance functions repair a node whose balance factor has reached 2 or -2, which is never stored. A single rotation is used when the taller child leans the same
+way or is even, and a double rotation when it leans the other way, and the balance factors are set from the known shape of each case.
+
+@param[in]: The off-balance node, and where to report whether the subtree ended up shorter than it was with the imbalance.
+@return: The index of the node now at the top of the subtree.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+uint32_t CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::rebalanceRightHeavy(uint32_t node, bool& heightChanged)
+{
+    uint32_t rightChild = nodes[node].rightChild;
+    int childBalance = balanceOf(rightChild);
+    if (childBalance >= 0)
+    {
+        rotateLeft(rightChild);
+        setBalance(node, childBalance == 0 ? 1 : 0);
+        setBalance(rightChild, childBalance == 0 ? -1 : 0);
+        heightChanged = childBalance != 0;
+        return rightChild;
+    }
+
+    uint32_t rightleftChild = nodes[rightChild].leftChild;
+    int grandchildBalance = balanceOf(rightleftChild);
+    rotateRight(rightleftChild);
+    rotateLeft(rightleftChild);
+    setBalance(node, grandchildBalance > 0 ? -1 : 0);
+    setBalance(rightChild, grandchildBalance < 0 ? 1 : 0);
+    setBalance(rightleftChild, 0);
+    heightChanged = true;
+    return rightleftChild;
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+uint32_t CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::rebalanceLeftHeavy(uint32_t node, bool& heightChanged)
+{
+    uint32_t leftChild = nodes[node].leftChild;
+    int childBalance = balanceOf(leftChild);
+    if (childBalance <= 0)
+    {
+        rotateRight(leftChild);
+        setBalance(node, childBalance == 0 ? -1 : 0);
+        setBalance(leftChild, childBalance == 0 ? 1 : 0);
+        heightChanged = childBalance != 0;
+        return leftChild;
+    }
+
+    uint32_t leftrightChild = nodes[leftChild].rightChild;
+    int grandchildBalance = balanceOf(leftrightChild);
+    rotateLeft(leftrightChild);
+    rotateRight(leftrightChild);
+    setBalance(node, grandchildBalance < 0 ? 1 : 0);
+    setBalance(leftChild, grandchildBalance > 0 ? -1 : 0);
+    setBalance(leftrightChild, 0);
+    heightChanged = true;
+    return leftrightChild;
+}
+/*
+Rotate functions move a node up above its parent, as the BinarySearchTree rotations do, relinking children and parents by index. Balance factors are left to the
+rebalance functions.
+
+@param[in]: The node being rotated up.
+@return: The tree with the node rotated to the left or right.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::rotateLeft(uint32_t node)
+{
+    uint32_t parent = parentOf(node);
+    uint32_t nodeleftChild = nodes[node].leftChild;
+    uint32_t grandparent = parentOf(parent);
+
+    replaceChild(grandparent, parent, node);
+    setParent(node, grandparent);
+    nodes[parent].rightChild = nodeleftChild;
+    if (nodeleftChild != NO_NODE)
+        setParent(nodeleftChild, parent);
+    nodes[node].leftChild = parent;
+    setParent(parent, node);
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::rotateRight(uint32_t node)
+{
+    uint32_t parent = parentOf(node);
+    uint32_t noderightChild = nodes[node].rightChild;
+    uint32_t grandparent = parentOf(parent);
+
+    replaceChild(grandparent, parent, node);
+    setParent(node, grandparent);
+    nodes[parent].leftChild = noderightChild;
+    if (noderightChild != NO_NODE)
+        setParent(noderightChild, parent);
+    nodes[node].rightChild = parent;
+    setParent(parent, node);
+}
+/*
+Search function finds an item and returns a reference to the stored value, throwing an exception if it is missing.
+
+@param[in]: An item to search for in the tree.
+@return: The stored value equal to the item, or an exception if the item was not found.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+const DATA_TYPE& CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::search(const DATA_TYPE& item) const
+{
+    const DATA_TYPE* searchResult = find(item);
+    if (!searchResult)
+        throw ItemNotFoundException(__LINE__, "Item was not found");
+    return *searchResult;
+}
+/*
+Find parent or duplicate function descends from the root with one comparison per level, like its BinarySearchTree counterpart.
+
+@param[in]: The item being searched for, or a key the compare policy can compare against stored values, and where to store the result of the last comparison.
+@return: The index of the node holding the item, or of the parent an item would be attached to, or NO_NODE for an empty tree.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+template <typename KEY>
+uint32_t CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::findParentOrDuplicate(const KEY& item, int& lastComparison) const
+{
+    uint32_t current = root;
+    uint32_t parent = current;
+    lastComparison = 0;
+
+    while (current != NO_NODE)
+    {
+        parent = current;
+        lastComparison = compare(nodes[current].nodeValue, item);
+        if (!lastComparison)
+            break;
+        current = lastComparison > 0 ? nodes[current].leftChild : nodes[current].rightChild;
+    }
+
+    return parent;
+}
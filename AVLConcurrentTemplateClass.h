@@ -0,0 +1,456 @@
+/*
+@filename: AVL Concurrent Search Tree Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the ConcurrentBinarySearchTree class, a thread safe AVL search tree. Writers take a shared_mutex exclusively and run the
+ordinary BinarySearchTree insert and remove code, rotations included. Readers first try an optimistic path that takes no lock at all: they read a version
+counter, which writers make odd while they work, walk the nodes, and accept what they found only if the version is still the same even number afterwards.
+Readers therefore never wait for a rotation, and only fall back to taking the shared_mutex in shared mode after repeated conflicts with writers.
+
+Walking nodes while a writer changes them needs two things. The tree links are atomic, which the tree switches on for allocators declaring concurrent_readers,
+and removed nodes are not freed while an optimistic reader could still be looking at them. The RetiringAllocator hands removed nodes to ReaderEpochs, which
+frees them only once every reader that was running at the time has finished.
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h, and link with -pthread on Linux.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+
+/*
+Reader epochs class tracks the optimistic readers of a tree, so memory they may be reading is only freed once they are done. Readers register under the current
+epoch, and retired nodes are freed after the epoch has been advanced twice and the readers of both earlier epochs have left. Only readers that were already
+running are waited for, so a steady stream of new readers cannot hold a writer up. Retire and reclaim must be called by one writer at a time.
+*/
+class ReaderEpochs
+{
+    struct RetiredNode
+    {
+        void* node;
+        void (*reclaim)(void*);
+    };
+
+    atomic<unsigned long long> epoch{ 0 };
+    atomic<long> readers[2] = { { 0 }, { 0 } };
+    vector<RetiredNode> retiredNodes;
+
+public:
+    ReaderEpochs() = default;
+    ReaderEpochs(const ReaderEpochs&) = delete;
+    ReaderEpochs& operator=(const ReaderEpochs&) = delete;
+    ~ReaderEpochs()
+    {
+        reclaimAll();
+    }
+
+    /*
+    Enter and leave functions register a reader for the duration of a read. Enter checks that the epoch did not move while it registered, so a writer that has
+    already stopped waiting for that epoch never misses the reader.
+
+    @param[in]: For leave, the epoch returned by enter.
+    @return: For enter, the epoch the reader registered under.
+    */
+    unsigned long long enter()
+    {
+        while (true)
+        {
+            unsigned long long current = epoch.load();
+            readers[current & 1].fetch_add(1);
+            if (epoch.load() == current)
+                return current;
+            readers[current & 1].fetch_sub(1);
+        }
+    }
+    void leave(unsigned long long registered)
+    {
+        readers[registered & 1].fetch_sub(1, memory_order_release);
+    }
+    /*
+    Retire function queues a node that has been unlinked from the tree, along with the function that destroys and frees it.
+
+    @param[in]: The node, and its reclaim function.
+    @return: Nothing. The node is freed by a later reclaim.
+    */
+    void retire(void* node, void (*reclaim)(void*))
+    {
+        retiredNodes.push_back({ node, reclaim });
+    }
+    void* lastRetired() const
+    {
+        return retiredNodes.empty() ? nullptr : retiredNodes.back().node;
+    }
+    size_t retiredCount() const
+    {
+        return retiredNodes.size();
+    }
+    /*
+    Reclaim function advances the epoch twice, each time waiting for the readers of the epoch being left, and then frees every node retired before it was called.
+
+    @param[in]: Nothing.
+    @return: The retired nodes freed.
+    */
+    void reclaim()
+    {
+        for (int advance = 0; advance < 2; advance++)
+        {
+            unsigned long long previous = epoch.fetch_add(1);
+            while (readers[previous & 1].load() != 0)
+                this_thread::yield();
+        }
+        reclaimAll();
+    }
+    void reclaimAll()
+    {
+        for (RetiredNode& retired : retiredNodes)
+            retired.reclaim(retired.node);
+        retiredNodes.clear();
+    }
+};
+/*
+Retiring allocator is the node allocator of ConcurrentBinarySearchTree. Destroying and freeing a node only retires it to the tree's ReaderEpochs, which runs the
+destructor and frees the memory once no optimistic reader can reach the node. It declares concurrent_readers, which gives the tree atomic links.
+
+@param[in]: The type allocated, rebound to the tree node by the tree.
+@return: An allocator object pointing at the epochs of its tree, or freeing at once when it has none.
+*/
+template <typename TYPE>
+struct RetiringAllocator
+{
+    using value_type = TYPE;
+    using concurrent_readers = true_type;
+
+    ReaderEpochs* epochs = nullptr;
+
+    RetiringAllocator() = default;
+    RetiringAllocator(ReaderEpochs* readerEpochs) : epochs(readerEpochs) {}
+    template <typename OTHER>
+    RetiringAllocator(const RetiringAllocator<OTHER>& other) : epochs(other.epochs) {}
+
+    TYPE* allocate(size_t count)
+    {
+        return allocator<TYPE>().allocate(count);
+    }
+    //Destroy retires the object and its memory together, so the deallocate call that follows it has nothing left to do.
+    template <typename OBJECT>
+    void destroy(OBJECT* object)
+    {
+        if (!epochs)
+        {
+            object->~OBJECT();
+            return;
+        }
+        epochs->retire(object, [](void* retired) {
+            static_cast<OBJECT*>(retired)->~OBJECT();
+            allocator<OBJECT>().deallocate(static_cast<OBJECT*>(retired), 1);
+        });
+    }
+    void deallocate(TYPE* object, size_t count)
+    {
+        if (!epochs || count != 1)
+        {
+            allocator<TYPE>().deallocate(object, count);
+            return;
+        }
+        if (epochs->lastRetired() == object)
+            return;
+        epochs->retire(object, [](void* retired) { allocator<TYPE>().deallocate(static_cast<TYPE*>(retired), 1); });
+    }
+    template <typename OTHER>
+    bool operator==(const RetiringAllocator<OTHER>& other) const
+    {
+        return epochs == other.epochs;
+    }
+    template <typename OTHER>
+    bool operator!=(const RetiringAllocator<OTHER>& other) const
+    {
+        return epochs != other.epochs;
+    }
+};
+/*
+Concurrent binary search tree class lets any number of threads search, scan, insert, and remove at once. Values are returned by copy, since a reference into the
+tree could outlive the node once another thread removes it.
+
+@param[in]: The DATA_TYPE of the values, and the compare policy.
+@return: A thread safe AVL search tree.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>>
+class ConcurrentBinarySearchTree
+{
+    using Tree = BinarySearchTree<DATA_TYPE, Compare, RetiringAllocator<DATA_TYPE>>;
+    using Node = typename Tree::BinaryTreeNode;
+
+    //Optimistic attempts before a reader takes the lock, the longest path a reader follows before assuming it raced a writer, and the retired nodes that
+    //trigger a reclaim.
+    static const int OPTIMISTIC_ATTEMPTS = 4;
+    static const int MAX_PATH = 128;
+    static const size_t RECLAIM_THRESHOLD = 1024;
+
+    mutable shared_mutex treeMutex;
+    //Even while no writer is active, and odd while one is.
+    atomic<unsigned long long> version{ 0 };
+    mutable ReaderEpochs epochs;
+    Tree tree;
+    bool optimisticReads;
+
+    //Private function declarations.
+    template <typename READ>
+    void read(READ readNodes) const;
+    template <typename WRITE>
+    auto write(WRITE writeTree);
+    bool findValue(const DATA_TYPE& item, optional<DATA_TYPE>& result) const;
+
+public:
+    /*
+    Constructor creates an empty tree. Optimistic reads can be turned off, which leaves the plain shared_mutex locking, for comparison.
+
+    @param[in]: The compare policy instance, and whether readers try the optimistic path first.
+    @return: An empty concurrent tree.
+    */
+    ConcurrentBinarySearchTree(Compare cmp = defaultCompare<Compare>(), bool optimistic = true)
+        : tree(cmp, RetiringAllocator<DATA_TYPE>(&epochs)), optimisticReads(optimistic) {}
+
+    /*
+    Write functions behave like their BinarySearchTree counterparts, holding the lock exclusively while they run.
+
+    @param[in]: The item to insert or remove.
+    @return: For the try functions, whether the tree changed. Insert and remove throw as the tree does.
+    */
+    bool tryInsert(const DATA_TYPE& item)
+    {
+        return write([&]() { return tree.tryInsert(item).second; });
+    }
+    bool tryRemove(const DATA_TYPE& item)
+    {
+        return write([&]() { return tree.tryRemove(item); });
+    }
+    void insert(const DATA_TYPE& item)
+    {
+        if (!tryInsert(item))
+            throw DuplicateItemException(__LINE__, "Duplicate item detected. Unable to insert");
+    }
+    void remove(const DATA_TYPE& item)
+    {
+        if (!tryRemove(item))
+            throw ItemNotFoundException(__LINE__, "Item was not found");
+    }
+    void clear()
+    {
+        write([&]() { tree.clear(); });
+    }
+    /*
+    Find, contains, and search functions look up an item. Find returns a copy of the stored value if there is one, and search throws when there is not.
+
+    @param[in]: The item to look up.
+    @return: A copy of the stored value, whether it exists, or an exception if it does not.
+    */
+    optional<DATA_TYPE> find(const DATA_TYPE& item) const
+    {
+        optional<DATA_TYPE> result;
+        read([&]() { return findValue(item, result); });
+        return result;
+    }
+    bool contains(const DATA_TYPE& item) const
+    {
+        return find(item).has_value();
+    }
+    DATA_TYPE search(const DATA_TYPE& item) const
+    {
+        optional<DATA_TYPE> result = find(item);
+        if (!result)
+            throw ItemNotFoundException(__LINE__, "Item was not found");
+        return std::move(*result);
+    }
+    template <typename VISIT>
+    void forEachInRange(const DATA_TYPE& low, const DATA_TYPE& high, VISIT visit) const;
+    /*
+    Count function returns the number of values in the tree, read under the shared lock.
+
+    @param[in]: Nothing.
+    @return: The current number of values.
+    */
+    int count() const
+    {
+        shared_lock<shared_mutex> lock(treeMutex);
+        return tree.count();
+    }
+};
+/*
+Read function runs a read of the tree's nodes. On the optimistic path, the read is accepted when the version was even before it and unchanged after it, which
+means no writer touched the tree in between. The read function reports false when it gave up on a path that was too long to be real, which is treated as a
+conflict too. After a few conflicts, or with optimistic reads off, the read runs under the shared lock, where it cannot conflict.
+
+@param[in]: A function reading the nodes into its own results, which it must reset on each call, returning false if it gave up.
+@return: The results of the accepted read, or whatever the read function throws, with the reader's epoch left either way.
+*/
+template <typename DATA_TYPE, typename Compare>
+template <typename READ>
+void ConcurrentBinarySearchTree<DATA_TYPE, Compare>::read(READ readNodes) const
+{
+    //Leaves the epoch even if the read throws, since a reader left registered would make the next reclaim wait forever.
+    struct EpochGuard
+    {
+        ReaderEpochs& epochs;
+        unsigned long long registered;
+        EpochGuard(ReaderEpochs& readerEpochs) : epochs(readerEpochs), registered(readerEpochs.enter()) {}
+        ~EpochGuard()
+        {
+            epochs.leave(registered);
+        }
+    };
+
+    for (int attempt = 0; optimisticReads && attempt < OPTIMISTIC_ATTEMPTS; attempt++)
+    {
+        unsigned long long before = version.load(memory_order_acquire);
+        if (before & 1)
+        {
+            this_thread::yield();
+            continue;
+        }
+        bool finished, unchanged;
+        {
+            EpochGuard guard(epochs);
+            finished = readNodes();
+            atomic_thread_fence(memory_order_acquire);
+            unchanged = version.load(memory_order_relaxed) == before;
+        }
+        if (finished && unchanged)
+            return;
+    }
+
+    shared_lock<shared_mutex> lock(treeMutex);
+    readNodes();
+}
+/*
+Write function runs a change to the tree under the exclusive lock, with the version odd for its duration, even if the change throws. Once enough nodes have been
+retired, it also frees those no reader can still reach.
+
+@param[in]: A function changing the tree.
+@return: Whatever the change function returns.
+*/
+template <typename DATA_TYPE, typename Compare>
+template <typename WRITE>
+auto ConcurrentBinarySearchTree<DATA_TYPE, Compare>::write(WRITE writeTree)
+{
+    struct VersionBump
+    {
+        atomic<unsigned long long>& version;
+        VersionBump(atomic<unsigned long long>& treeVersion) : version(treeVersion)
+        {
+            version.store(version.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_release);
+        }
+        ~VersionBump()
+        {
+            version.store(version.load(memory_order_relaxed) + 1, memory_order_release);
+        }
+    };
+
+    unique_lock<shared_mutex> lock(treeMutex);
+    struct Reclaim
+    {
+        ReaderEpochs& epochs;
+        ~Reclaim()
+        {
+            if (epochs.retiredCount() >= RECLAIM_THRESHOLD)
+                epochs.reclaim();
+        }
+    } reclaim{ epochs };
+    VersionBump bump(version);
+    return writeTree();
+}
+/*
+Find value function descends from the root with one comparison per level, as findParentOrDuplicate does, but copies out the value it finds. A descent longer
+than any real AVL path means links changed under it, so it gives up.
+
+@param[in]: The item to look up, and where to store a copy of the value.
+@return: False if the descent gave up, otherwise true with the result set.
+*/
+template <typename DATA_TYPE, typename Compare>
+bool ConcurrentBinarySearchTree<DATA_TYPE, Compare>::findValue(const DATA_TYPE& item, optional<DATA_TYPE>& result) const
+{
+    result.reset();
+    Node* current = tree.root;
+    for (int depth = 0; current; depth++)
+    {
+        if (depth > MAX_PATH)
+            return false;
+        int comparison = tree.compare(current->nodeValue, item);
+        if (!comparison)
+        {
+            result = current->nodeValue;
+            break;
+        }
+        current = comparison > 0 ? current->leftChild.load() : current->rightChild.load();
+    }
+    return true;
+}
+/*
+For each in range function copies the values between low and high, inclusive of both, in one read of the tree, then calls the visit function on the copies in
+ascending order, after the read is over.
+
+@param[in]: The low and high ends of the range, and the function to call on each value.
+@return: Nothing. Visits every value in the range as of a single point in time.
+*/
+template <typename DATA_TYPE, typename Compare>
+template <typename VISIT>
+void ConcurrentBinarySearchTree<DATA_TYPE, Compare>::forEachInRange(const DATA_TYPE& low, const DATA_TYPE& high, VISIT visit) const
+{
+    vector<DATA_TYPE> values;
+    read([&]() {
+        values.clear();
+        //Lower bound of low, found the way lowerBoundNode does, keeping the last node the descent went left at.
+        Node* current = tree.root;
+        Node* bound = nullptr;
+        int steps = 0;
+        while (current)
+        {
+            if (++steps > MAX_PATH)
+                return false;
+            int comparison = tree.compare(current->nodeValue, low);
+            if (comparison >= 0)
+                bound = current;
+            if (!comparison)
+                break;
+            current = comparison > 0 ? current->leftChild.load() : current->rightChild.load();
+        }
+
+        //Successor walk, allowing a full climb and descent for each value before assuming links changed under it.
+        for (current = bound; current && tree.compare(current->nodeValue, high) <= 0;)
+        {
+            values.push_back(current->nodeValue);
+            Node* next = current->rightChild;
+            if (next)
+            {
+                while (Node* left = next->leftChild)
+                {
+                    next = left;
+                    if (++steps > MAX_PATH * (int)(values.size() + 1))
+                        return false;
+                }
+            }
+            else
+            {
+                next = current->parent;
+                while (next && next->rightChild.load() == current)
+                {
+                    current = next;
+                    next = next->parent;
+                    if (++steps > MAX_PATH * (int)(values.size() + 1))
+                        return false;
+                }
+            }
+            current = next;
+        }
+        return true;
+    });
+
+    for (const DATA_TYPE& value : values)
+        visit(value);
+}
@@ -0,0 +1,358 @@
+/*
+@filename: AVL Frozen Search Tree Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the FrozenSearchTree class, an immutable snapshot of an AVL search tree laid out for lookups. The mutable trees keep taking
+writes, and freeze() exports their current contents into a snapshot that serves reads. Values are stored in one array in Eytzinger order, the breadth first
+order of a perfectly balanced tree, so a lookup walks down the array with index arithmetic alone, without branching on the comparisons, while prefetching the
+cache lines a few levels ahead.
+
+Arithmetic values under the default compare policy use a blocked version of the same layout instead, where every node of the implicit tree is a cache line of
+sorted values with one more child than it has values. A whole node is compared against the searched value at once, using AVX2 or SSE2 instructions for int and
+float values when the compiler targets them, so the search takes one cache line per level of a much shallower tree.
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h, and before calling freeze(). Compile with -mavx2 or /arch:AVX2 to use the AVX2 kernels.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include "AVLCompactTemplateClass.h"
+#include <bitset>
+#include <limits>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+/*
+Cache line allocator hands out memory aligned to a 64 byte cache line, so each block of the blocked layout occupies exactly one line.
+*/
+template <typename TYPE>
+struct CacheLineAllocator
+{
+    using value_type = TYPE;
+    static const size_t CACHE_LINE = 64;
+
+    CacheLineAllocator() = default;
+    template <typename OTHER>
+    CacheLineAllocator(const CacheLineAllocator<OTHER>&) {}
+
+    TYPE* allocate(size_t count)
+    {
+        return static_cast<TYPE*>(::operator new(count * sizeof(TYPE), align_val_t(CACHE_LINE)));
+    }
+    void deallocate(TYPE* pointer, size_t)
+    {
+        ::operator delete(pointer, align_val_t(CACHE_LINE));
+    }
+    template <typename OTHER>
+    bool operator==(const CacheLineAllocator<OTHER>&) const
+    {
+        return true;
+    }
+    template <typename OTHER>
+    bool operator!=(const CacheLineAllocator<OTHER>&) const
+    {
+        return false;
+    }
+};
+/*
+Frozen search tree class holds an immutable, sorted snapshot of a set of values. lowerBound and contains follow findParentOrDuplicate: the compare policy decides
+the order, lowerBound finds the first value the policy does not rank below the searched item, and contains reports whether that value compares equal to it.
+
+@param[in]: The DATA_TYPE of the values, and the compare policy of the tree the snapshot was taken from.
+@return: A read only snapshot object.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>>
+class FrozenSearchTree
+{
+public:
+    //Whether the blocked layout and its multi-value comparison kernel are used for this DATA_TYPE and compare policy.
+    static constexpr bool BLOCKED = is_arithmetic<DATA_TYPE>::value && is_same<Compare, ThreeWayCompare<DATA_TYPE>>::value;
+
+private:
+    //Values per block of the blocked layout, and how many elements ahead the Eytzinger search prefetches, both one cache line's worth.
+    static constexpr size_t BLOCK_VALUES = sizeof(DATA_TYPE) < 64 ? 64 / sizeof(DATA_TYPE) : 1;
+    static constexpr size_t PREFETCH_STRIDE = BLOCK_VALUES;
+    static constexpr size_t NO_POSITION = (size_t)-1;
+
+    //Eytzinger layout. The value for implicit tree index k, counting from 1, is stored at layout[k - 1].
+    vector<DATA_TYPE> layout;
+    //Blocked layout, padded with the largest value of DATA_TYPE, and the largest real value for telling padding apart.
+    vector<DATA_TYPE, CacheLineAllocator<DATA_TYPE>> blocks;
+    size_t blockCount = 0;
+    DATA_TYPE largestValue = DATA_TYPE();
+    size_t valueCount = 0;
+    Compare compare;
+
+    //Private function declarations.
+    void buildEytzinger(const vector<const DATA_TYPE*>& sorted, size_t& next, vector<size_t>& order, size_t k);
+    void buildBlocks(const vector<const DATA_TYPE*>& sorted, size_t& next, size_t block);
+    template <typename KEY>
+    const DATA_TYPE* eytzingerLowerBound(const KEY& item) const;
+    const DATA_TYPE* blockedLowerBound(DATA_TYPE item) const;
+    static size_t blockRank(const DATA_TYPE* block, DATA_TYPE item);
+
+    static DATA_TYPE paddingValue()
+    {
+        if constexpr (numeric_limits<DATA_TYPE>::has_infinity)
+            return numeric_limits<DATA_TYPE>::infinity();
+        else
+            return numeric_limits<DATA_TYPE>::max();
+    }
+
+public:
+    FrozenSearchTree(Compare cmp = defaultCompare<Compare>()) : compare(cmp) {}
+    template <typename ITERATOR>
+    FrozenSearchTree(ITERATOR first, ITERATOR last, Compare cmp = defaultCompare<Compare>());
+
+    /*
+    Lower bound functions find the first value not less than an item, and contains functions check whether a value equal to the item exists. The overloads
+    taking a key of another type are available when the compare policy declares is_transparent, and always search the Eytzinger layout.
+
+    @param[in]: An item, or a key the compare policy can compare against stored values.
+    @return: A pointer to the bound value or null, or whether the item is present.
+    */
+    const DATA_TYPE* lowerBound(const DATA_TYPE& item) const
+    {
+        if constexpr (BLOCKED)
+            return blockedLowerBound(item);
+        else
+            return eytzingerLowerBound(item);
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    const DATA_TYPE* lowerBound(const KEY& key) const
+    {
+        static_assert(!BLOCKED, "Arithmetic snapshots only search for DATA_TYPE values");
+        return eytzingerLowerBound(key);
+    }
+    bool contains(const DATA_TYPE& item) const
+    {
+        const DATA_TYPE* bound = lowerBound(item);
+        return bound && compare(*bound, item) == 0;
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const KEY& key) const
+    {
+        const DATA_TYPE* bound = lowerBound(key);
+        return bound && compare(*bound, key) == 0;
+    }
+    /*
+    Count function returns the number of values in the snapshot.
+
+    @param[in]: Nothing.
+    @return: The number of values.
+    */
+    int count() const
+    {
+        return (int)valueCount;
+    }
+};
+/*
+Range constructor copies the values of a sorted range into the layout for this DATA_TYPE. The range is walked once to collect pointers to its values, which must
+be in strictly ascending order as assignSorted requires, and the values are then copied straight to their places in the layout.
+
+@param[in]: A range of forward iterators over the values, such as the iterators of a tree, and the compare policy.
+@return: A snapshot holding the values of the range. An unsorted or duplicated range throws.
+*/
+template <typename DATA_TYPE, typename Compare>
+template <typename ITERATOR>
+FrozenSearchTree<DATA_TYPE, Compare>::FrozenSearchTree(ITERATOR first, ITERATOR last, Compare cmp) : compare(cmp)
+{
+    vector<const DATA_TYPE*> sorted;
+    for (; first != last; ++first)
+    {
+        const DATA_TYPE& item = *first;
+        if (!sorted.empty())
+        {
+            int result = compare(*sorted.back(), item);
+            if (result == 0)
+                throw DuplicateItemException(__LINE__, "Duplicate item detected. Unable to freeze");
+            if (result > 0)
+                throw UnsortedInputException(__LINE__, "Items are not in ascending order. Unable to freeze");
+        }
+        sorted.push_back(&item);
+    }
+    valueCount = sorted.size();
+
+    size_t next = 0;
+    if constexpr (BLOCKED)
+    {
+        blockCount = (valueCount + BLOCK_VALUES - 1) / BLOCK_VALUES;
+        blocks.assign(blockCount * BLOCK_VALUES, paddingValue());
+        if (valueCount)
+            largestValue = *sorted.back();
+        buildBlocks(sorted, next, 0);
+    }
+    else
+    {
+        vector<size_t> order(valueCount);
+        buildEytzinger(sorted, next, order, 1);
+        layout.reserve(valueCount);
+        for (size_t k = 0; k < valueCount; k++)
+            layout.push_back(*sorted[order[k]]);
+    }
+}
+/*
+Build Eytzinger function walks the implicit tree in order, so the n-th index visited receives the n-th smallest value. It records which sorted value belongs at
+each index, and the values are copied afterwards in index order.
+
+@param[in]: The sorted values, the next unused sorted position, the index to sorted position table being filled, and the implicit tree index, counting from 1.
+@return: The table filled for the subtree at index k.
+*/
+template <typename DATA_TYPE, typename Compare>
+void FrozenSearchTree<DATA_TYPE, Compare>::buildEytzinger(const vector<const DATA_TYPE*>& sorted, size_t& next, vector<size_t>& order, size_t k)
+{
+    if (k > valueCount)
+        return;
+    buildEytzinger(sorted, next, order, 2 * k);
+    order[k - 1] = next++;
+    buildEytzinger(sorted, next, order, 2 * k + 1);
+}
+/*
+Build blocks function fills the blocked layout in order. Block k has BLOCK_VALUES + 1 children, numbered k * (BLOCK_VALUES + 1) + i + 1, and child i holds the
+values that fall between value i - 1 and value i of block k. Slots left over once the values run out keep the padding value, so they sort after every real value.
+
+@param[in]: The sorted values, the next unused sorted position, and the block to fill.
+@return: The blocks of the subtree at the block filled.
+*/
+template <typename DATA_TYPE, typename Compare>
+void FrozenSearchTree<DATA_TYPE, Compare>::buildBlocks(const vector<const DATA_TYPE*>& sorted, size_t& next, size_t block)
+{
+    if (block >= blockCount)
+        return;
+    for (size_t i = 0; i < BLOCK_VALUES; i++)
+    {
+        buildBlocks(sorted, next, block * (BLOCK_VALUES + 1) + i + 1);
+        if (next < valueCount)
+            blocks[block * BLOCK_VALUES + i] = *sorted[next++];
+    }
+    buildBlocks(sorted, next, block * (BLOCK_VALUES + 1) + BLOCK_VALUES + 1);
+}
+/*
+Eytzinger lower bound function descends the implicit tree, going right from index k to 2k + 1 when the value there is less than the item and left to 2k otherwise,
+which compiles to a conditional move rather than a branch. Once past the last index, the bits of k record the path taken, and dropping the trailing right turns
+and the final left turn gives the index of the last value the search went left at, which is the lower bound.
+
+@param[in]: An item, or a key the compare policy can compare against stored values.
+@return: A pointer to the first value not less than the item, or null if there is none.
+*/
+template <typename DATA_TYPE, typename Compare>
+template <typename KEY>
+const DATA_TYPE* FrozenSearchTree<DATA_TYPE, Compare>::eytzingerLowerBound(const KEY& item) const
+{
+    const DATA_TYPE* values = layout.data();
+    size_t k = 1;
+    while (k <= valueCount)
+    {
+        //Prefetch where the search will be a few levels down. The address is formed as an integer since it may be past the end of the array.
+        AVL_PREFETCH((const void*)((uintptr_t)values + (k * PREFETCH_STRIDE - 1) * sizeof(DATA_TYPE)));
+        k = 2 * k + (compare(values[k - 1], item) < 0);
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    k >>= __builtin_ffsll((long long)~k);
+#else
+    while (k & 1)
+        k >>= 1;
+    k >>= 1;
+#endif
+    return k ? &values[k - 1] : nullptr;
+}
+/*
+Blocked lower bound function descends the blocked layout. At each block, the number of its values that are less than the item selects the child to visit next,
+and the value at that position, when it exists, is the best lower bound found so far.
+
+@param[in]: An item.
+@return: A pointer to the first value not less than the item, or null if there is none.
+*/
+template <typename DATA_TYPE, typename Compare>
+const DATA_TYPE* FrozenSearchTree<DATA_TYPE, Compare>::blockedLowerBound(DATA_TYPE item) const
+{
+    const DATA_TYPE* values = blocks.data();
+    size_t position = NO_POSITION;
+    size_t block = 0;
+    while (block < blockCount)
+    {
+        size_t rank = blockRank(values + block * BLOCK_VALUES, item);
+        position = rank < BLOCK_VALUES ? block * BLOCK_VALUES + rank : position;
+        block = block * (BLOCK_VALUES + 1) + rank + 1;
+    }
+    //A padding slot is only a real bound if the largest value equals the padding value.
+    if (position == NO_POSITION || values[position] > largestValue)
+        return nullptr;
+    return &values[position];
+}
+/*
+Block rank function counts the values of a block that are less than the item, which for a sorted block is the position the item would take in it. For int and
+float values with the default block size of 16, it compares the whole block at once with AVX2 or SSE2 and counts the bits of the comparison mask. Other types use a
+plain loop without branches, which the compiler is free to vectorize.
+
+@param[in]: The first value of a block, and the item.
+@return: The number of values in the block less than the item.
+*/
+template <typename DATA_TYPE, typename Compare>
+size_t FrozenSearchTree<DATA_TYPE, Compare>::blockRank(const DATA_TYPE* block, DATA_TYPE item)
+{
+#if defined(__AVX2__)
+    if constexpr (is_same<DATA_TYPE, int>::value)
+    {
+        __m256i key = _mm256_set1_epi32(item);
+        __m256i less0 = _mm256_cmpgt_epi32(key, _mm256_loadu_si256((const __m256i*)block));
+        __m256i less1 = _mm256_cmpgt_epi32(key, _mm256_loadu_si256((const __m256i*)(block + 8)));
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(less0)) | ((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(less1)) << 8);
+        return bitset<16>(mask).count();
+    }
+    if constexpr (is_same<DATA_TYPE, float>::value)
+    {
+        __m256 key = _mm256_set1_ps(item);
+        __m256 less0 = _mm256_cmp_ps(_mm256_loadu_ps(block), key, _CMP_LT_OQ);
+        __m256 less1 = _mm256_cmp_ps(_mm256_loadu_ps(block + 8), key, _CMP_LT_OQ);
+        unsigned mask = (unsigned)_mm256_movemask_ps(less0) | ((unsigned)_mm256_movemask_ps(less1) << 8);
+        return bitset<16>(mask).count();
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    if constexpr (is_same<DATA_TYPE, int>::value)
+    {
+        __m128i key = _mm_set1_epi32(item);
+        __m128i less0 = _mm_cmpgt_epi32(key, _mm_loadu_si128((const __m128i*)block));
+        __m128i less1 = _mm_cmpgt_epi32(key, _mm_loadu_si128((const __m128i*)(block + 4)));
+        __m128i less2 = _mm_cmpgt_epi32(key, _mm_loadu_si128((const __m128i*)(block + 8)));
+        __m128i less3 = _mm_cmpgt_epi32(key, _mm_loadu_si128((const __m128i*)(block + 12)));
+        __m128i packed = _mm_packs_epi16(_mm_packs_epi32(less0, less1), _mm_packs_epi32(less2, less3));
+        return bitset<16>((unsigned)_mm_movemask_epi8(packed)).count();
+    }
+    if constexpr (is_same<DATA_TYPE, float>::value)
+    {
+        __m128 key = _mm_set1_ps(item);
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(block), key));
+        mask |= (unsigned)_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(block + 4), key)) << 4;
+        mask |= (unsigned)_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(block + 8), key)) << 8;
+        mask |= (unsigned)_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(block + 12), key)) << 12;
+        return bitset<16>(mask).count();
+    }
+#endif
+    size_t rank = 0;
+    for (size_t i = 0; i < BLOCK_VALUES; i++)
+        rank += block[i] < item;
+    return rank;
+}
+/*
+Freeze functions export the current contents of a tree into a new frozen snapshot. The tree stays as it is and can keep changing, while the snapshot keeps the
+contents it was given.
+
+@param[in]: Nothing.
+@return: A frozen snapshot of the tree, sharing its compare policy.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+FrozenSearchTree<DATA_TYPE, Compare> BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::freeze() const
+{
+    return FrozenSearchTree<DATA_TYPE, Compare>(begin(), end(), compare);
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+FrozenSearchTree<DATA_TYPE, Compare> CompactBinarySearchTree<DATA_TYPE, Compare, Allocator>::freeze() const
+{
+    return FrozenSearchTree<DATA_TYPE, Compare>(begin(), end(), compare);
+}
@@ -0,0 +1,451 @@
+/*
+@filename: AVL Tree Image Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the binary image format that trees of trivially copyable values are saved in, the save and load functions of the
+BinarySearchTree, and the MappedSearchTree class, which serves read only lookups straight out of a memory mapped image.
+
+An image is a fixed header followed by one record per node. Nodes are written in breadth first order, and each record holds the node's value and the indices
+of its two children within the image rather than pointers, so the image means the same thing wherever it is loaded or mapped. Loading an image walks the records
+in order and hands the values to assignSorted, rebuilding the tree in O(n) without a single search or rotation. Mapping an image reads nothing up front: lookups
+walk the records in place, and only the pages they touch are ever read from disk.
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h, and before calling save() or load().
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+Tree image exception inherits from the general exception class and reports that an image could not be written or read, or was not a valid image of the tree.
+
+@param[in]: Inherited info on error from Exception class.
+@return: Text output stating the image error has occurred.
+*/
+class TreeImageException : public Exception
+{
+public:
+    TreeImageException(int eNo, string msg) : Exception(eNo, msg) {}
+    string toString()
+    {
+        stringstream sstream;
+        sstream << "TreeImageException: " << errorNumber << " ERROR: " << message;
+        return sstream.str();
+    }
+};
+/*
+Tree image header struct starts every image. The format version changes whenever the layout does, and the value and record sizes catch an image being read as
+the wrong DATA_TYPE. Images are written in the byte order of the machine that saves them.
+*/
+struct TreeImageHeader
+{
+    static const uint32_t FORMAT_VERSION = 1;
+
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t valueSize;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t nodeCount;
+
+    static const char* expectedMagic()
+    {
+        return "AVLTREE";
+    }
+};
+/*
+Tree image node struct is the record of one node. Children are indices into the records of the image, always greater than the index of the node itself since
+records are in breadth first order, with NO_CHILD for a missing child.
+*/
+template <typename DATA_TYPE>
+struct TreeImageNode
+{
+    static const uint32_t NO_CHILD = 0xFFFFFFFF;
+
+    DATA_TYPE nodeValue;
+    uint32_t leftChild;
+    uint32_t rightChild;
+};
+/*
+Tree image layout functions give where the records of an image start, rounded up from the header to the alignment of a record, and check a header against the
+DATA_TYPE being read and the size of the image. Trees count their values in an int, so an image holding more than INT_MAX records is rejected too.
+
+@param[in]: The header read, and the size of the whole image in bytes.
+@return: The offset of the first record, or an exception if the header does not describe a valid image.
+*/
+template <typename DATA_TYPE>
+constexpr size_t treeImageRecordOffset()
+{
+    return (sizeof(TreeImageHeader) + alignof(TreeImageNode<DATA_TYPE>) - 1) / alignof(TreeImageNode<DATA_TYPE>) * alignof(TreeImageNode<DATA_TYPE>);
+}
+template <typename DATA_TYPE>
+void checkTreeImageHeader(const TreeImageHeader& header, uint64_t imageSize)
+{
+    if (memcmp(header.magic, TreeImageHeader::expectedMagic(), sizeof(header.magic)) != 0)
+        throw TreeImageException(__LINE__, "File is not a tree image");
+    if (header.formatVersion != TreeImageHeader::FORMAT_VERSION)
+        throw TreeImageException(__LINE__, "Tree image format version is not supported");
+    if (header.valueSize != sizeof(DATA_TYPE) || header.recordSize != sizeof(TreeImageNode<DATA_TYPE>))
+        throw TreeImageException(__LINE__, "Tree image was saved with a different value type");
+    if (header.nodeCount > (uint64_t)INT_MAX)
+        throw TreeImageException(__LINE__, "Tree image holds more items than a tree can count");
+    if ((imageSize - treeImageRecordOffset<DATA_TYPE>()) / sizeof(TreeImageNode<DATA_TYPE>) < header.nodeCount)
+        throw TreeImageException(__LINE__, "Tree image is truncated");
+}
+/*
+Replace tree image function moves a fully written image over the path it was saved for, replacing any image there in one step.
+
+@param[in]: The path of the written image, and the path it replaces.
+@return: True if the image was moved into place.
+*/
+inline bool replaceTreeImage(const string& writtenPath, const string& path)
+{
+#ifdef _WIN32
+    return MoveFileExA(writtenPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(writtenPath.c_str(), path.c_str()) == 0;
+#endif
+}
+/*
+Save function writes the tree to a binary image at the path, replacing any file there. Nodes are numbered in breadth first order as they are written, so each
+child's index is known when its parent's record is written and the file is written front to back in large chunks.
+
+The image is written to the path with .tmp added and only moved over the path once it has been closed without error, so a crash or failed write partway
+leaves the previous image at the path untouched.
+
+@param[in]: The path of the image to write.
+@return: Nothing, or an exception if the file could not be written, with any previous image at the path left in place.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::save(const string& path) const
+{
+    static_assert(is_trivially_copyable<DATA_TYPE>::value, "save requires a trivially copyable DATA_TYPE");
+
+    const string writtenPath = path + ".tmp";
+    ofstream image(writtenPath, ios::binary | ios::trunc);
+    if (!image)
+        throw TreeImageException(__LINE__, "Unable to open tree image for writing");
+    try
+    {
+        writeImage(image);
+        image.close();
+        if (image.fail())
+            throw TreeImageException(__LINE__, "Unable to write tree image");
+        if (!replaceTreeImage(writtenPath, path))
+            throw TreeImageException(__LINE__, "Unable to replace tree image");
+    }
+    catch (...)
+    {
+        image.close();
+        std::remove(writtenPath.c_str());
+        throw;
+    }
+}
+/*
+Write image function writes the header and the records of the tree to an open image stream, for save.
+
+@param[in]: The stream to write to.
+@return: Nothing. Write errors are left on the stream for save to check.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::writeImage(ostream& image) const
+{
+    using Record = TreeImageNode<DATA_TYPE>;
+    const size_t CHUNK_RECORDS = 65536;
+
+    TreeImageHeader header{};
+    memcpy(header.magic, TreeImageHeader::expectedMagic(), sizeof(header.magic));
+    header.formatVersion = TreeImageHeader::FORMAT_VERSION;
+    header.valueSize = sizeof(DATA_TYPE);
+    header.recordSize = sizeof(Record);
+    header.nodeCount = (uint64_t)nodeCount;
+    char padding[treeImageRecordOffset<DATA_TYPE>()] = {};
+    memcpy(padding, &header, sizeof(header));
+    image.write(padding, sizeof(padding));
+
+    vector<BinaryTreeNode*> order;
+    order.reserve(nodeCount);
+    if (root)
+        order.push_back(root);
+    vector<Record> chunk;
+    chunk.reserve(CHUNK_RECORDS);
+    for (size_t next = 0; next < order.size(); next++)
+    {
+        BinaryTreeNode* node = order[next];
+        //Value initialized, so the padding written to the file is zeroed.
+        Record record{};
+        record.nodeValue = node->nodeValue;
+        record.leftChild = record.rightChild = Record::NO_CHILD;
+        if (node->leftChild)
+        {
+            record.leftChild = (uint32_t)order.size();
+            order.push_back(node->leftChild);
+        }
+        if (node->rightChild)
+        {
+            record.rightChild = (uint32_t)order.size();
+            order.push_back(node->rightChild);
+        }
+        chunk.push_back(record);
+        if (chunk.size() == CHUNK_RECORDS || next + 1 == order.size())
+        {
+            image.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(Record));
+            chunk.clear();
+        }
+    }
+}
+/*
+Load function replaces the contents of the tree with an image written by save. The records are read in one block and walked in order with a stack, checking
+that every child index points forwards and within the image so a damaged file cannot send the walk round in circles, and the values are then bulk loaded with
+assignSorted in O(n), which also rejects an image whose values are out of order.
+
+@param[in]: The path of the image to read.
+@return: The tree holding the values of the image, or an exception, leaving the tree unchanged, if the image cannot be read or is not valid.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::load(const string& path)
+{
+    static_assert(is_trivially_copyable<DATA_TYPE>::value, "load requires a trivially copyable DATA_TYPE");
+    using Record = TreeImageNode<DATA_TYPE>;
+
+    ifstream image(path, ios::binary | ios::ate);
+    if (!image)
+        throw TreeImageException(__LINE__, "Unable to open tree image for reading");
+    uint64_t imageSize = (uint64_t)image.tellg();
+    TreeImageHeader header{};
+    image.seekg(0);
+    if (imageSize < treeImageRecordOffset<DATA_TYPE>() || !image.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw TreeImageException(__LINE__, "Tree image is truncated");
+    checkTreeImageHeader<DATA_TYPE>(header, imageSize);
+    vector<Record> records((size_t)header.nodeCount);
+    image.seekg(treeImageRecordOffset<DATA_TYPE>());
+    if (!image.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record)))
+        throw TreeImageException(__LINE__, "Tree image is truncated");
+
+    vector<DATA_TYPE> values;
+    values.reserve(records.size());
+    vector<uint32_t> pending;
+    uint32_t current = records.empty() ? Record::NO_CHILD : 0;
+    while (current != Record::NO_CHILD || !pending.empty())
+    {
+        for (; current != Record::NO_CHILD; current = records[current].leftChild)
+        {
+            pending.push_back(current);
+            uint32_t left = records[current].leftChild;
+            uint32_t right = records[current].rightChild;
+            if ((left != Record::NO_CHILD && (left <= current || left >= records.size())) || (right != Record::NO_CHILD && (right <= current || right >= records.size())))
+                throw TreeImageException(__LINE__, "Tree image has an invalid child index");
+        }
+        current = pending.back();
+        pending.pop_back();
+        values.push_back(records[current].nodeValue);
+        if (values.size() > records.size())
+            throw TreeImageException(__LINE__, "Tree image has an invalid child index");
+        current = records[current].rightChild;
+    }
+    if (values.size() != records.size())
+        throw TreeImageException(__LINE__, "Tree image has unreachable nodes");
+    try
+    {
+        assignSorted(make_move_iterator(values.begin()), make_move_iterator(values.end()));
+    }
+    catch (DuplicateItemException&)
+    {
+        throw TreeImageException(__LINE__, "Tree image values are not in order");
+    }
+    catch (UnsortedInputException&)
+    {
+        throw TreeImageException(__LINE__, "Tree image values are not in order");
+    }
+}
+/*
+Mapped search tree class maps an image written by save into memory read only and answers lookups by walking its records in place. Opening it reads only the
+header, so it is ready in constant time however large the image is, and several processes mapping the same image share one copy in the page cache. Child
+indices are checked as they are followed, so a damaged image can make lookups wrong but never read outside the mapping or loop.
+
+@param[in]: The DATA_TYPE of the values, which must be trivially copyable, and the compare policy the image was saved with.
+@return: A read only search tree over a mapped image.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>>
+class MappedSearchTree
+{
+    static_assert(is_trivially_copyable<DATA_TYPE>::value, "MappedSearchTree requires a trivially copyable DATA_TYPE");
+    using Record = TreeImageNode<DATA_TYPE>;
+
+    const Record* records = nullptr;
+    uint32_t nodeCount = 0;
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    Compare compare;
+#ifdef _WIN32
+    HANDLE mappingHandle = nullptr;
+#endif
+
+    //Private function declarations.
+    void unmap();
+    /*
+    Child function follows a child index, treating one that does not point forwards within the image as missing.
+
+    @param[in]: The index of the current record, and the child index it holds.
+    @return: The child index, or NO_CHILD.
+    */
+    uint32_t child(uint32_t current, uint32_t next) const
+    {
+        return next > current && next < nodeCount ? next : Record::NO_CHILD;
+    }
+
+public:
+    MappedSearchTree(const string& path, Compare cmp = defaultCompare<Compare>());
+    MappedSearchTree(const MappedSearchTree&) = delete;
+    MappedSearchTree& operator=(const MappedSearchTree&) = delete;
+    ~MappedSearchTree()
+    {
+        unmap();
+    }
+
+    /*
+    Find, contains, and lower bound functions look up a value in the mapped image, with one comparison per level as in the tree itself.
+
+    @param[in]: The item to look up.
+    @return: A pointer into the mapping at the value equal to the item or null, whether it exists, or a pointer to the first value not less than it or null.
+    */
+    const DATA_TYPE* find(const DATA_TYPE& item) const
+    {
+        uint32_t current = nodeCount ? 0 : Record::NO_CHILD;
+        while (current != Record::NO_CHILD)
+        {
+            int comparison = compare(records[current].nodeValue, item);
+            if (!comparison)
+                return &records[current].nodeValue;
+            current = child(current, comparison > 0 ? records[current].leftChild : records[current].rightChild);
+        }
+        return nullptr;
+    }
+    bool contains(const DATA_TYPE& item) const
+    {
+        return find(item) != nullptr;
+    }
+    const DATA_TYPE* lowerBound(const DATA_TYPE& item) const
+    {
+        const DATA_TYPE* bound = nullptr;
+        uint32_t current = nodeCount ? 0 : Record::NO_CHILD;
+        while (current != Record::NO_CHILD)
+        {
+            int comparison = compare(records[current].nodeValue, item);
+            if (comparison >= 0)
+                bound = &records[current].nodeValue;
+            if (!comparison)
+                break;
+            current = child(current, comparison > 0 ? records[current].leftChild : records[current].rightChild);
+        }
+        return bound;
+    }
+    /*
+    Count function returns the number of values in the image.
+
+    @param[in]: Nothing.
+    @return: The number of values.
+    */
+    int count() const
+    {
+        return (int)nodeCount;
+    }
+};
+/*
+Constructor maps the image at the path read only and checks its header. The mapping stays in place until the tree is destroyed.
+
+@param[in]: The path of the image, and the compare policy instance.
+@return: A mapped search tree over the image, or an exception if the image cannot be mapped or is not valid.
+*/
+template <typename DATA_TYPE, typename Compare>
+MappedSearchTree<DATA_TYPE, Compare>::MappedSearchTree(const string& path, Compare cmp) : compare(cmp)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw TreeImageException(__LINE__, "Unable to open tree image for mapping");
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    mappingSize = (size_t)fileSize.QuadPart;
+    if (mappingSize >= sizeof(TreeImageHeader))
+    {
+        mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle)
+            mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+    CloseHandle(file);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        throw TreeImageException(__LINE__, "Unable to open tree image for mapping");
+    struct stat fileStatus;
+    if (fstat(file, &fileStatus) == 0)
+        mappingSize = (size_t)fileStatus.st_size;
+    if (mappingSize >= sizeof(TreeImageHeader))
+    {
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, file, 0);
+        if (mapping == MAP_FAILED)
+            mapping = nullptr;
+    }
+    close(file);
+#endif
+    if (!mapping)
+    {
+        unmap();
+        throw TreeImageException(__LINE__, "Unable to map tree image");
+    }
+
+    try
+    {
+        if (mappingSize < treeImageRecordOffset<DATA_TYPE>())
+            throw TreeImageException(__LINE__, "Tree image is truncated");
+        const TreeImageHeader& header = *static_cast<const TreeImageHeader*>(mapping);
+        checkTreeImageHeader<DATA_TYPE>(header, mappingSize);
+        nodeCount = (uint32_t)header.nodeCount;
+        records = reinterpret_cast<const Record*>(static_cast<const char*>(mapping) + treeImageRecordOffset<DATA_TYPE>());
+    }
+    catch (...)
+    {
+        unmap();
+        throw;
+    }
+}
+/*
+Unmap function releases the mapping, if there is one.
+
+@param[in]: Nothing.
+@return: Nothing. The records can no longer be read.
+*/
+template <typename DATA_TYPE, typename Compare>
+void MappedSearchTree<DATA_TYPE, Compare>::unmap()
+{
+#ifdef _WIN32
+    if (mapping)
+        UnmapViewOfFile(mapping);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    mappingHandle = nullptr;
+#else
+    if (mapping)
+        munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    records = nullptr;
+    nodeCount = 0;
+}
@@ -0,0 +1,398 @@
+/*
+@filename: AVL Intrusive Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the IntrusiveAVLTree class, an AVL tree over objects the caller already owns. Rather than copying each value into a node it
+allocates, the tree links objects through an AVLHook embedded in them, holding the left, right, and parent links and the height that serves as the balance
+field. Inserting and removing link and unlink the objects in place, with no allocation and no copy, and rebalance with the same AVLTreeLinks code as
+BinarySearchTree. An object with several hooks, told apart by a tag type, can be indexed by several trees at once.
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include <utility>
+
+template <typename T, typename Compare, typename TAG>
+class IntrusiveAVLTree;
+/*
+AVL hook class is embedded in an object, as a base class, to let an IntrusiveAVLTree link the object in. It holds the links and the height of the subtree the
+object roots, which is zero while the object is in no tree. Copying an object does not copy its hook, so a copy always starts out unlinked.
+
+@param[in]: A tag type telling apart the hooks of an object indexed by more than one tree. Defaults to void.
+@return: An unlinked hook.
+*/
+template <typename TAG = void>
+class AVLHook
+{
+    template <typename, typename, typename>
+    friend class IntrusiveAVLTree;
+    template <typename, typename, bool>
+    friend class AVLTreeLinks;
+
+    AVLHook* leftChild = nullptr;
+    AVLHook* rightChild = nullptr;
+    AVLHook* parent = nullptr;
+    //Tree height of the subtree this object roots, which the rebalancing compares to find the balance. Zero while unlinked.
+    int treeHeight = 0;
+
+public:
+    AVLHook() = default;
+    AVLHook(const AVLHook&) {}
+    AVLHook& operator=(const AVLHook&)
+    {
+        return *this;
+    }
+    /*
+    Is linked function tells whether the object is currently in a tree through this hook.
+
+    @param[in]: Nothing.
+    @return: True if the object is linked into a tree.
+    */
+    bool isLinked() const
+    {
+        return treeHeight != 0;
+    }
+};
+/*
+Intrusive AVL tree class orders objects the caller owns by linking their hooks. The tree never allocates, copies, or destroys an object, and an object must stay
+at the same address, and keep the fields the compare policy reads unchanged, while it is linked. Clearing or destroying the tree unlinks every object left in it.
+
+@param[in]: The object type, which derives from AVLHook<TAG>, the compare policy for objects, and the tag of the hook this tree uses.
+@return: An AVL balancing search tree over existing objects.
+*/
+template <typename T, typename Compare = ThreeWayCompare<T>, typename TAG = void>
+class IntrusiveAVLTree : AVLTreeLinks<IntrusiveAVLTree<T, Compare, TAG>, AVLHook<TAG>>
+{
+    using Hook = AVLHook<TAG>;
+    using Links = AVLTreeLinks<IntrusiveAVLTree, Hook>;
+    friend Links;
+    using Links::leftmostNode;
+    using Links::rightmostNode;
+    using Links::successorNode;
+    using Links::predecessorNode;
+#ifdef AVL_TREE_STATS
+    using Links::touchedNodes;
+#endif
+
+    Hook* root;
+    int nodeCount;
+    Compare compare;
+
+    /*
+    Value of and hook of functions convert between an object and the hook this tree links it by.
+
+    @param[in]: A linked hook, or an object.
+    @return: The object holding the hook, or the hook of the object.
+    */
+    static T& valueOf(Hook* hook)
+    {
+        return static_cast<T&>(*hook);
+    }
+    static Hook* hookOf(T& item)
+    {
+        return &static_cast<Hook&>(item);
+    }
+    /*
+    Reset hook function returns a hook to the unlinked state, once the tree no longer reaches it.
+
+    @param[in]: The hook being unlinked.
+    @return: Nothing. The hook is unlinked.
+    */
+    static void resetHook(Hook* hook)
+    {
+        hook->leftChild = hook->rightChild = hook->parent = nullptr;
+        hook->treeHeight = 0;
+    }
+    /*
+    Find parent or duplicate function descends from the root with one comparison per level, as BinarySearchTree's does.
+
+    @param[in]: The object or key being searched for, and where to store the result of the last comparison made.
+    @return: The hook holding the item, or the parent an object equal to it would be linked below, or null for an empty tree.
+    */
+    template <typename KEY>
+    Hook* findParentOrDuplicate(const KEY& item, int& lastComparison) const
+    {
+        Hook* current = root;
+        Hook* parent = current;
+        lastComparison = 0;
+        while (current)
+        {
+            parent = current;
+            AVL_TOUCH_NODES(1);
+            lastComparison = compare(valueOf(current), item);
+            if (!lastComparison)
+                break;
+            current = lastComparison > 0 ? current->leftChild : current->rightChild;
+        }
+        return parent;
+    }
+    /*
+    Bound node function finds the first hook whose object is not less than the item, or greater than it when the bound is strict.
+
+    @param[in]: The object or key to bound, and whether the bound is strict.
+    @return: The hook at the bound, or null.
+    */
+    template <typename KEY>
+    Hook* boundNode(const KEY& item, bool strict) const
+    {
+        Hook* bound = nullptr;
+        for (Hook* current = root; current;)
+        {
+            int comparison = compare(valueOf(current), item);
+            if (comparison > 0 || (!strict && comparison == 0))
+            {
+                bound = current;
+                current = current->leftChild;
+            }
+            else
+                current = current->rightChild;
+        }
+        return bound;
+    }
+
+public:
+    /*
+    Iterator class is a bidirectional iterator over the linked objects in order, walking the hooks' parent links. The objects are given out as references the
+    caller may change, other than the fields the compare policy reads.
+
+    @param[in]: The tree being traversed and the hook the iterator is positioned at, null for the end position.
+    @return: An iterator usable with range-for loops and the standard algorithms.
+    */
+    class Iterator
+    {
+        const IntrusiveAVLTree* tree;
+        Hook* node;
+
+        friend class IntrusiveAVLTree;
+        Iterator(const IntrusiveAVLTree* owner, Hook* position) : tree(owner), node(position) {}
+
+    public:
+        using iterator_category = bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        Iterator() : tree(nullptr), node(nullptr) {}
+
+        reference operator*() const
+        {
+            return valueOf(node);
+        }
+        pointer operator->() const
+        {
+            return &valueOf(node);
+        }
+        Iterator& operator++()
+        {
+            node = successorNode(node);
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+        Iterator& operator--()
+        {
+            node = node ? predecessorNode(node) : rightmostNode(tree->root);
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator previous = *this;
+            --(*this);
+            return previous;
+        }
+        bool operator==(const Iterator& other) const
+        {
+            return node == other.node;
+        }
+        bool operator!=(const Iterator& other) const
+        {
+            return node != other.node;
+        }
+    };
+    using iterator = Iterator;
+
+    IntrusiveAVLTree(Compare cmp = defaultCompare<Compare>()) : root(nullptr), nodeCount(0), compare(cmp) {}
+    IntrusiveAVLTree(const IntrusiveAVLTree&) = delete;
+    IntrusiveAVLTree& operator=(const IntrusiveAVLTree&) = delete;
+    ~IntrusiveAVLTree()
+    {
+        clear();
+    }
+
+    /*
+    Try insert function links an object into the tree in place, unless an equal object is already linked. Insert function does the same, but throws a duplicate
+    item exception instead. Linking an object whose hook is already in a tree throws a duplicate item exception from both.
+
+    @param[in]: The object to link, which stays owned by the caller.
+    @return: An iterator at the object, or at the equal object already linked, and whether the object was linked.
+    */
+    pair<Iterator, bool> tryInsert(T& item)
+    {
+        Hook* hook = hookOf(item);
+        if (hook->isLinked())
+            throw DuplicateItemException(__LINE__, "Item is already linked into a tree");
+        int lastComparison;
+        Hook* searchNode = findParentOrDuplicate(item, lastComparison);
+        if (searchNode && !lastComparison)
+            return { Iterator(this, searchNode), false };
+
+        hook->treeHeight = 1;
+        nodeCount++;
+        this->linkAndRebalance(searchNode, hook, lastComparison);
+        return { Iterator(this, hook), true };
+    }
+    void insert(T& item)
+    {
+        if (!tryInsert(item).second)
+            throw DuplicateItemException(__LINE__, "Duplicate item in insertion");
+    }
+    /*
+    Remove function unlinks an object from the tree in place, rebalancing on the way up, with no search. The object must be linked into this tree, and one that
+    is not linked at all throws an item not found exception. Try remove function finds the object equal to an item and unlinks it.
+
+    @param[in]: The linked object to unlink, or an item equal to the object to unlink.
+    @return: Nothing, or the unlinked object, null when there was none.
+    */
+    void remove(T& item)
+    {
+        Hook* hook = hookOf(item);
+        if (!hook->isLinked())
+            throw ItemNotFoundException(__LINE__, "Item is not linked into a tree");
+        this->unlinkAndRebalance(hook);
+        resetHook(hook);
+        nodeCount--;
+    }
+    T* tryRemove(const T& item)
+    {
+        T* found = find(item);
+        if (found)
+            remove(*found);
+        return found;
+    }
+    /*
+    Find function searches for the object equal to an item, and lower bound and upper bound functions find the first object not less than, or greater than, it.
+    Each also has an overload taking a key of another type, available only when the compare policy declares is_transparent.
+
+    @param[in]: An object, or a key the compare policy can compare against objects.
+    @return: The linked object or null, or an iterator at the bound or end.
+    */
+    T* find(const T& item) const
+    {
+        int lastComparison;
+        Hook* node = findParentOrDuplicate(item, lastComparison);
+        return node && !lastComparison ? &valueOf(node) : nullptr;
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    T* find(const KEY& key) const
+    {
+        int lastComparison;
+        Hook* node = findParentOrDuplicate(key, lastComparison);
+        return node && !lastComparison ? &valueOf(node) : nullptr;
+    }
+    Iterator lowerBound(const T& item) const
+    {
+        return Iterator(this, boundNode(item, false));
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    Iterator lowerBound(const KEY& key) const
+    {
+        return Iterator(this, boundNode(key, false));
+    }
+    Iterator upperBound(const T& item) const
+    {
+        return Iterator(this, boundNode(item, true));
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    Iterator upperBound(const KEY& key) const
+    {
+        return Iterator(this, boundNode(key, true));
+    }
+    /*
+    Iterator to function gives the position of an object linked into this tree in O(1), straight from its hook, so an object found through one index can be
+    stepped from in another.
+
+    @param[in]: An object linked into this tree.
+    @return: An iterator at the object.
+    */
+    Iterator iteratorTo(T& item) const
+    {
+        return Iterator(this, hookOf(item));
+    }
+    /*
+    Is linked function tells whether an object is in a tree through the hook this tree uses.
+
+    @param[in]: An object.
+    @return: True if the object is linked.
+    */
+    static bool isLinked(const T& item)
+    {
+        return static_cast<const Hook&>(item).isLinked();
+    }
+    /*
+    Clear function unlinks every object, leaving the tree empty. The walk goes down to a leaf, unlinks it, and climbs back up through the parent link, so it uses
+    no recursion or stack.
+
+    @param[in]: Nothing.
+    @return: An empty tree, with every object it held unlinked.
+    */
+    void clear()
+    {
+        Hook* node = root;
+        while (node)
+        {
+            if (node->leftChild)
+                node = node->leftChild;
+            else if (node->rightChild)
+                node = node->rightChild;
+            else
+            {
+                Hook* parent = node->parent;
+                if (parent)
+                {
+                    if (parent->leftChild == node)
+                        parent->leftChild = nullptr;
+                    else
+                        parent->rightChild = nullptr;
+                }
+                resetHook(node);
+                node = parent;
+            }
+        }
+        root = nullptr;
+        nodeCount = 0;
+    }
+    /*
+    Validate function checks every invariant of the tree with validateLinks, as BinarySearchTree's does.
+
+    @param[in]: Nothing.
+    @return: Nothing, or an exception naming the first broken invariant found.
+    */
+    void validate() const
+    {
+        this->validateLinks(nodeCount, [this](Hook* previous, Hook* current) { return compare(valueOf(previous), valueOf(current)) < 0; });
+    }
+    /*
+    Count function returns the number of linked objects, and the iterator functions walk them in order.
+    */
+    int count() const
+    {
+        return nodeCount;
+    }
+    Iterator begin() const
+    {
+        return Iterator(this, root ? leftmostNode(root) : nullptr);
+    }
+    Iterator end() const
+    {
+        return Iterator(this, nullptr);
+    }
+};
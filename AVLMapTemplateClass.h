@@ -0,0 +1,239 @@
+/*
+@filename: AVL Map Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the AVLMap class, which uses the AVL search tree template class as an index from keys to values. Entries are stored as key
+and value pairs ordered by key alone, so lookups only need a key rather than a full dummy record, and a transparent key compare policy lets keys of other
+types, such as string_view, probe the map without building a temporary key.
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include <tuple>
+#include <utility>
+
+/*
+Map key compare class adapts a key compare policy into a compare policy for the key and value pairs stored in the tree. Pairs are compared by their keys, and
+a pair can also be compared against a lone key, which lets the tree search by key. It declares is_transparent so the tree accepts keys for its lookups, while
+AVLMap itself only passes keys of other types through when the key compare policy is transparent too.
+
+@param[in]: Key and value types of the map, and the compare policy for keys.
+@return: A compare policy usable by BinarySearchTree for the stored pairs.
+*/
+template <typename KEY_TYPE, typename VALUE_TYPE, typename KeyCompare>
+struct MapKeyCompare
+{
+    using is_transparent = void;
+    using value_type = pair<const KEY_TYPE, VALUE_TYPE>;
+
+    KeyCompare keyCompare;
+
+    int operator()(const value_type& item1, const value_type& item2) const
+    {
+        return keyCompare(item1.first, item2.first);
+    }
+    template <typename KEY>
+    int operator()(const value_type& item, const KEY& key) const
+    {
+        return keyCompare(item.first, key);
+    }
+};
+/*
+AVL map class stores key and value pairs in a BinarySearchTree ordered by key. Values can be read and changed in place through operator[], at, find, and
+insert_or_assign, while iterators give read only access to the pairs in key order. Missing keys reported by at and remove use the same exceptions as the tree.
+
+@param[in]: Key and value types, the compare policy for keys (ThreeWayCompare<> for heterogeneous lookups), and the allocator for the pairs.
+@return: An ordered map object backed by an AVL tree.
+*/
+template <typename KEY_TYPE, typename VALUE_TYPE, typename KeyCompare = ThreeWayCompare<KEY_TYPE>, typename Allocator = allocator<pair<const KEY_TYPE, VALUE_TYPE>>>
+class AVLMap
+{
+public:
+    using value_type = pair<const KEY_TYPE, VALUE_TYPE>;
+    using Tree = BinarySearchTree<value_type, MapKeyCompare<KEY_TYPE, VALUE_TYPE, KeyCompare>, Allocator>;
+    using iterator = typename Tree::iterator;
+    using const_iterator = typename Tree::const_iterator;
+
+private:
+    Tree tree;
+
+    /*
+    Mutable value function gives write access to the value of a stored pair. The tree only hands out const pairs so keys cannot be changed, but the pair
+    objects themselves are not const, so removing the const from the value is well defined.
+
+    @param[in]: A stored pair.
+    @return: The value of the pair.
+    */
+    static VALUE_TYPE& mutableValue(const value_type& item)
+    {
+        return const_cast<VALUE_TYPE&>(item.second);
+    }
+
+public:
+    AVLMap(KeyCompare cmp = defaultCompare<KeyCompare>(), const Allocator& alloc = Allocator()) : tree(MapKeyCompare<KEY_TYPE, VALUE_TYPE, KeyCompare>{ cmp }, alloc) {}
+
+    /*
+    Subscript operators return the value for a key, inserting a default constructed value first if the key is missing. The key is looked up before anything is
+    constructed, so a hit costs a single descent.
+
+    @param[in]: The key to look up, copied or moved into the map when it is missing.
+    @return: A reference to the value for the key.
+    */
+    VALUE_TYPE& operator[](const KEY_TYPE& key)
+    {
+        return mutableValue(*tree.tryEmplace(key, piecewise_construct, forward_as_tuple(key), forward_as_tuple()).first);
+    }
+    VALUE_TYPE& operator[](KEY_TYPE&& key)
+    {
+        return mutableValue(*tree.tryEmplace(key, piecewise_construct, forward_as_tuple(std::move(key)), forward_as_tuple()).first);
+    }
+    /*
+    At functions return the value for a key that must already be in the map.
+
+    @param[in]: The key to look up, or a key of another type when KeyCompare is transparent.
+    @return: A reference to the value, or an exception if the key was not found.
+    */
+    VALUE_TYPE& at(const KEY_TYPE& key)
+    {
+        VALUE_TYPE* value = find(key);
+        if (!value)
+            throw ItemNotFoundException(__LINE__, "Key was not found");
+        return *value;
+    }
+    const VALUE_TYPE& at(const KEY_TYPE& key) const
+    {
+        const VALUE_TYPE* value = find(key);
+        if (!value)
+            throw ItemNotFoundException(__LINE__, "Key was not found");
+        return *value;
+    }
+    template <typename KEY, typename C = KeyCompare, typename = typename C::is_transparent>
+    VALUE_TYPE& at(const KEY& key)
+    {
+        VALUE_TYPE* value = find(key);
+        if (!value)
+            throw ItemNotFoundException(__LINE__, "Key was not found");
+        return *value;
+    }
+    template <typename KEY, typename C = KeyCompare, typename = typename C::is_transparent>
+    const VALUE_TYPE& at(const KEY& key) const
+    {
+        const VALUE_TYPE* value = find(key);
+        if (!value)
+            throw ItemNotFoundException(__LINE__, "Key was not found");
+        return *value;
+    }
+    /*
+    Insert or assign functions store a value for a key, inserting a new pair if the key is missing or assigning over the old value if it exists.
+
+    @param[in]: The key, copied or moved into the map when it is missing, and the value to store.
+    @return: An iterator at the pair for the key, and whether a new pair was inserted.
+    */
+    template <typename VALUE>
+    pair<iterator, bool> insert_or_assign(const KEY_TYPE& key, VALUE&& value)
+    {
+        pair<iterator, bool> result = tree.tryEmplace(key, key, std::forward<VALUE>(value));
+        if (!result.second)
+            mutableValue(*result.first) = std::forward<VALUE>(value);
+        return result;
+    }
+    template <typename VALUE>
+    pair<iterator, bool> insert_or_assign(KEY_TYPE&& key, VALUE&& value)
+    {
+        pair<iterator, bool> result = tree.tryEmplace(key, std::move(key), std::forward<VALUE>(value));
+        if (!result.second)
+            mutableValue(*result.first) = std::forward<VALUE>(value);
+        return result;
+    }
+    /*
+    Find functions look up the value for a key without throwing when it is missing.
+
+    @param[in]: The key to look up, or a key of another type when KeyCompare is transparent.
+    @return: A pointer to the value, or null if the key was not found.
+    */
+    VALUE_TYPE* find(const KEY_TYPE& key)
+    {
+        const value_type* item = tree.find(key);
+        return item ? &mutableValue(*item) : nullptr;
+    }
+    const VALUE_TYPE* find(const KEY_TYPE& key) const
+    {
+        const value_type* item = tree.find(key);
+        return item ? &item->second : nullptr;
+    }
+    template <typename KEY, typename C = KeyCompare, typename = typename C::is_transparent>
+    VALUE_TYPE* find(const KEY& key)
+    {
+        const value_type* item = tree.find(key);
+        return item ? &mutableValue(*item) : nullptr;
+    }
+    template <typename KEY, typename C = KeyCompare, typename = typename C::is_transparent>
+    const VALUE_TYPE* find(const KEY& key) const
+    {
+        const value_type* item = tree.find(key);
+        return item ? &item->second : nullptr;
+    }
+    /*
+    Remove functions delete the pair for a key. Remove throws an item not found exception when the key is missing, while tryRemove reports it instead.
+
+    @param[in]: The key to delete, or a key of another type when KeyCompare is transparent.
+    @return: For tryRemove, true if a pair was removed.
+    */
+    void remove(const KEY_TYPE& key)
+    {
+        if (!tree.tryRemove(key))
+            throw ItemNotFoundException(__LINE__, "Key was not found");
+    }
+    bool tryRemove(const KEY_TYPE& key)
+    {
+        return tree.tryRemove(key);
+    }
+    template <typename KEY, typename C = KeyCompare, typename = typename C::is_transparent>
+    bool tryRemove(const KEY& key)
+    {
+        return tree.tryRemove(key);
+    }
+    /*
+    Lower bound and upper bound functions find the first pair whose key is not less than, or greater than, a key.
+
+    @param[in]: The key to bound, or a key of another type when KeyCompare is transparent.
+    @return: An iterator at the bound, or end.
+    */
+    iterator lowerBound(const KEY_TYPE& key) const
+    {
+        return tree.lowerBound(key);
+    }
+    iterator upperBound(const KEY_TYPE& key) const
+    {
+        return tree.upperBound(key);
+    }
+    template <typename KEY, typename C = KeyCompare, typename = typename C::is_transparent>
+    iterator lowerBound(const KEY& key) const
+    {
+        return tree.lowerBound(key);
+    }
+    template <typename KEY, typename C = KeyCompare, typename = typename C::is_transparent>
+    iterator upperBound(const KEY& key) const
+    {
+        return tree.upperBound(key);
+    }
+    /*
+    Count function returns the number of pairs in the map, and the iterator functions walk the pairs in key order.
+    */
+    int count() const
+    {
+        return tree.count();
+    }
+    iterator begin() const
+    {
+        return tree.begin();
+    }
+    iterator end() const
+    {
+        return tree.end();
+    }
+};
@@ -0,0 +1,214 @@
+/*
+@filename: AVL Multiset Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the AVLMultiset class, which uses the AVL search tree template class to hold values that may repeat. Each distinct value is
+stored once, in a node that also carries its multiplicity, the number of copies held. Repeating a value that is already present is a single descent that
+bumps the counter, with no allocation and no rebalancing, so heavily repeated keys neither need salting to be told apart nor grow the tree. Counting,
+removing one copy, and removing every copy of a value are all O(log n).
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include <utility>
+
+/*
+Multiset entry struct is what the multiset stores in each node: a distinct value, and the number of copies of it the multiset holds.
+*/
+template <typename DATA_TYPE>
+struct MultisetEntry
+{
+    DATA_TYPE value;
+    long long multiplicity;
+
+    template <typename VALUE>
+    MultisetEntry(VALUE&& item, long long copies) : value(std::forward<VALUE>(item)), multiplicity(copies) {}
+};
+/*
+Multiset value compare class adapts a value compare policy into a compare policy for the entries stored in the tree. Entries are compared by their values, and
+an entry can also be compared against a lone value, so the tree searches by value without building an entry. It declares is_transparent so the tree accepts
+values for its lookups.
+
+@param[in]: The value type of the multiset, and the compare policy for values.
+@return: A compare policy usable by BinarySearchTree for the stored entries.
+*/
+template <typename DATA_TYPE, typename Compare>
+struct MultisetValueCompare
+{
+    using is_transparent = void;
+    using entry_type = MultisetEntry<DATA_TYPE>;
+
+    Compare valueCompare;
+
+    int operator()(const entry_type& item1, const entry_type& item2) const
+    {
+        return valueCompare(item1.value, item2.value);
+    }
+    int operator()(const entry_type& item, const DATA_TYPE& value) const
+    {
+        return valueCompare(item.value, value);
+    }
+};
+/*
+AVL multiset class stores values that may repeat in a BinarySearchTree of distinct values, each with a count of its copies. distinctCount is the number of
+nodes and totalCount the number of values counting every copy, and iterators walk the entries in order, one per distinct value.
+
+@param[in]: The value type, the compare policy for values, and the allocator for the entries.
+@return: An ordered multiset object backed by an AVL tree.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>, typename Allocator = allocator<MultisetEntry<DATA_TYPE>>>
+class AVLMultiset
+{
+public:
+    using entry_type = MultisetEntry<DATA_TYPE>;
+    using Tree = BinarySearchTree<entry_type, MultisetValueCompare<DATA_TYPE, Compare>, Allocator>;
+    using iterator = typename Tree::iterator;
+    using const_iterator = typename Tree::const_iterator;
+
+private:
+    Tree tree;
+    //Values held counting every copy. The tree's own count is the number of distinct values.
+    long long elementCount = 0;
+
+    /*
+    Mutable multiplicity function gives write access to the count of a stored entry. The tree only hands out const entries so values cannot be changed, but the
+    entry objects themselves are not const, so removing the const from the count is well defined.
+
+    @param[in]: A stored entry.
+    @return: The multiplicity of the entry.
+    */
+    static long long& mutableMultiplicity(const entry_type& item)
+    {
+        return const_cast<long long&>(item.multiplicity);
+    }
+    /*
+    Add copy function finishes an insert: a new entry already holds its one copy, while an existing entry has the copy added to its count.
+
+    @param[in]: The result of tryEmplace.
+    @return: The multiplicity of the value after the insert.
+    */
+    long long addCopy(pair<iterator, bool> result)
+    {
+        if (!result.second)
+            mutableMultiplicity(*result.first)++;
+        elementCount++;
+        return result.first->multiplicity;
+    }
+
+public:
+    AVLMultiset(Compare cmp = defaultCompare<Compare>(), const Allocator& alloc = Allocator()) : tree(MultisetValueCompare<DATA_TYPE, Compare>{ cmp }, alloc) {}
+
+    /*
+    Insert functions add a copy of a value. A value already present costs one descent to find its node and bump the count, and a new value is linked in by the
+    same descent.
+
+    @param[in]: The value, copied or moved into the multiset when it is new.
+    @return: The multiplicity of the value after the insert.
+    */
+    long long insert(const DATA_TYPE& item)
+    {
+        return addCopy(tree.tryEmplace(item, item, 1LL));
+    }
+    long long insert(DATA_TYPE&& item)
+    {
+        return addCopy(tree.tryEmplace(item, std::move(item), 1LL));
+    }
+    /*
+    Count function returns how many copies of a value the multiset holds, and contains whether it holds any.
+
+    @param[in]: The value to look up.
+    @return: The multiplicity of the value, zero when it is missing, or whether it is present.
+    */
+    long long count(const DATA_TYPE& item) const
+    {
+        const entry_type* entry = tree.find(item);
+        return entry ? entry->multiplicity : 0;
+    }
+    bool contains(const DATA_TYPE& item) const
+    {
+        return tree.find(item) != nullptr;
+    }
+    /*
+    Erase one function removes a single copy of a value. While other copies remain it only lowers the count, and the node is removed with the last copy.
+
+    @param[in]: The value to remove a copy of.
+    @return: True if a copy was removed, or false if the value was missing.
+    */
+    bool eraseOne(const DATA_TYPE& item)
+    {
+        const entry_type* entry = tree.find(item);
+        if (!entry)
+            return false;
+        if (entry->multiplicity > 1)
+            mutableMultiplicity(*entry)--;
+        else
+            tree.tryRemove(item);
+        elementCount--;
+        return true;
+    }
+    /*
+    Erase all function removes every copy of a value, along with its node.
+
+    @param[in]: The value to remove.
+    @return: The number of copies removed, zero when the value was missing.
+    */
+    long long eraseAll(const DATA_TYPE& item)
+    {
+        const entry_type* entry = tree.find(item);
+        if (!entry)
+            return 0;
+        long long copies = entry->multiplicity;
+        tree.tryRemove(item);
+        elementCount -= copies;
+        return copies;
+    }
+    /*
+    Clear function removes every value.
+
+    @param[in]: Nothing.
+    @return: An empty multiset.
+    */
+    void clear()
+    {
+        tree.clear();
+        elementCount = 0;
+    }
+    /*
+    Lower bound and upper bound functions find the first entry whose value is not less than, or greater than, a value.
+
+    @param[in]: The value to bound.
+    @return: An iterator at the bound, or end.
+    */
+    iterator lowerBound(const DATA_TYPE& item) const
+    {
+        return tree.lowerBound(item);
+    }
+    iterator upperBound(const DATA_TYPE& item) const
+    {
+        return tree.upperBound(item);
+    }
+    /*
+    Distinct count and total count functions return the number of distinct values, which is the number of nodes, and the number of values counting every copy.
+    The iterator functions walk the entries in value order.
+    */
+    int distinctCount() const
+    {
+        return tree.count();
+    }
+    long long totalCount() const
+    {
+        return elementCount;
+    }
+    iterator begin() const
+    {
+        return tree.begin();
+    }
+    iterator end() const
+    {
+        return tree.end();
+    }
+};
@@ -0,0 +1,558 @@
+/*
+@filename: AVL Persistent Search Tree Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the PersistentBinarySearchTree class, a persistent AVL search tree that keeps every version it publishes intact. Nodes are never
+changed once built. An insert or remove copies only the nodes on the path from the root to the change, along with the nodes a rotation rearranges, and shares
+every other subtree with the previous version. Each write then publishes its new root atomically.
+
+Readers take a Snapshot of the current version without locking and can scan it for as long as they like while writes continue, seeing the tree exactly as it
+was when the snapshot was taken. Nodes and versions are reference counted, so a version is freed when the tree and the last snapshot holding it let go. The
+tree's ReaderEpochs make sure that a snapshot being taken never races the release of the version it is taking.
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h, and link with -pthread on Linux.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include "AVLConcurrentTemplateClass.h"
+#include <atomic>
+#include <mutex>
+
+/*
+Persistent binary search tree class holds the versions of a persistent AVL tree. Writes are serialized with a mutex, while snapshots can be taken and read from
+any number of threads.
+
+@param[in]: The DATA_TYPE of the values, which must be copyable since rotations copy values into new nodes, and the compare policy.
+@return: A persistent AVL search tree.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>>
+class PersistentBinarySearchTree
+{
+    /*
+    Persistent node struct holds a value, the height of its subtree, and its children. A node is shared by every version and every parent that reach it, and
+    counts those references.
+    */
+    struct PersistentNode
+    {
+        DATA_TYPE nodeValue;
+        int treeHeight;
+        PersistentNode* leftChild;
+        PersistentNode* rightChild;
+        atomic<int> references;
+
+        template <typename VALUE>
+        PersistentNode(VALUE&& value, int height, PersistentNode* left, PersistentNode* right)
+            : nodeValue(std::forward<VALUE>(value)), treeHeight(height), leftChild(left), rightChild(right), references(0) {}
+    };
+    /*
+    Node handle class holds one reference to a node, taking it when created or copied and dropping it when destroyed. A node whose last reference is dropped is
+    freed, along with any of its children left without references, using a stack rather than recursion.
+    */
+    class NodeHandle
+    {
+        PersistentNode* node;
+
+    public:
+        NodeHandle(PersistentNode* target = nullptr) : node(target)
+        {
+            if (node)
+                node->references.fetch_add(1, memory_order_relaxed);
+        }
+        NodeHandle(const NodeHandle& other) : NodeHandle(other.node) {}
+        NodeHandle(NodeHandle&& other) noexcept : node(other.node)
+        {
+            other.node = nullptr;
+        }
+        NodeHandle& operator=(NodeHandle other) noexcept
+        {
+            std::swap(node, other.node);
+            return *this;
+        }
+        ~NodeHandle()
+        {
+            release(node);
+        }
+        PersistentNode* get() const
+        {
+            return node;
+        }
+        PersistentNode* operator->() const
+        {
+            return node;
+        }
+        explicit operator bool() const
+        {
+            return node != nullptr;
+        }
+        //Release takes the reference that a node or handle held on a child, which also happens when a freed node lets go of its children.
+        static void release(PersistentNode* node)
+        {
+            if (!node || node->references.fetch_sub(1, memory_order_acq_rel) != 1)
+                return;
+            vector<PersistentNode*> pending = { node };
+            while (!pending.empty())
+            {
+                PersistentNode* current = pending.back();
+                pending.pop_back();
+                if (current->leftChild && current->leftChild->references.fetch_sub(1, memory_order_acq_rel) == 1)
+                    pending.push_back(current->leftChild);
+                if (current->rightChild && current->rightChild->references.fetch_sub(1, memory_order_acq_rel) == 1)
+                    pending.push_back(current->rightChild);
+                delete current;
+            }
+        }
+    };
+    /*
+    Version struct is one published state of the tree: its root, size, and number. The tree holds a reference to the current version, and each snapshot to the
+    version it was taken from.
+    */
+    struct Version
+    {
+        atomic<int> references;
+        NodeHandle root;
+        int nodeCount;
+        unsigned long long number;
+
+        Version(NodeHandle versionRoot, int count, unsigned long long versionNumber) : references(1), root(std::move(versionRoot)), nodeCount(count), number(versionNumber) {}
+
+        static void release(void* released)
+        {
+            Version* version = static_cast<Version*>(released);
+            if (version->references.fetch_sub(1, memory_order_acq_rel) == 1)
+                delete version;
+        }
+    };
+
+public:
+    /*
+    Write stats struct reports the nodes a write copied and the memory they take. Writes that change nothing, such as inserting a duplicate, copy nothing.
+    */
+    struct WriteStats
+    {
+        size_t writes = 0;
+        size_t nodesCopied = 0;
+        size_t bytesCopied = 0;
+    };
+    /*
+    Snapshot class is a read only view of one version of the tree. It keeps the version alive while it exists, and can be copied and read from any thread.
+    Pointers to values it returns stay valid as long as the snapshot does. It keeps a copy of the tree's compare policy, so its lookups order values as the tree
+    does.
+    */
+    class Snapshot
+    {
+        Version* version;
+        Compare compare;
+
+        friend class PersistentBinarySearchTree;
+        Snapshot(Version* acquired, const Compare& cmp) : version(acquired), compare(cmp) {}
+
+    public:
+        Snapshot(const Snapshot& other) : version(other.version), compare(other.compare)
+        {
+            version->references.fetch_add(1, memory_order_relaxed);
+        }
+        Snapshot& operator=(Snapshot other)
+        {
+            std::swap(version, other.version);
+            std::swap(compare, other.compare);
+            return *this;
+        }
+        ~Snapshot()
+        {
+            Version::release(version);
+        }
+
+        /*
+        Count and version number functions describe the version the snapshot was taken from. Version numbers start at 0 for the empty tree and grow by one with
+        each write that changed the tree.
+
+        @param[in]: Nothing.
+        @return: The number of values, or the version number.
+        */
+        int count() const
+        {
+            return version->nodeCount;
+        }
+        unsigned long long versionNumber() const
+        {
+            return version->number;
+        }
+        /*
+        Find, contains, and lower bound functions look up values of the version, with the same one comparison per level as findParentOrDuplicate.
+
+        @param[in]: The item to look up.
+        @return: A pointer to the value equal to the item or null, whether it exists, or a pointer to the first value not less than it or null.
+        */
+        const DATA_TYPE* find(const DATA_TYPE& item) const
+        {
+            for (PersistentNode* current = version->root.get(); current;)
+            {
+                int comparison = compare(current->nodeValue, item);
+                if (!comparison)
+                    return &current->nodeValue;
+                current = comparison > 0 ? current->leftChild : current->rightChild;
+            }
+            return nullptr;
+        }
+        bool contains(const DATA_TYPE& item) const
+        {
+            return find(item) != nullptr;
+        }
+        const DATA_TYPE* lowerBound(const DATA_TYPE& item) const
+        {
+            const DATA_TYPE* bound = nullptr;
+            for (PersistentNode* current = version->root.get(); current;)
+            {
+                int comparison = compare(current->nodeValue, item);
+                if (comparison >= 0)
+                    bound = &current->nodeValue;
+                if (!comparison)
+                    break;
+                current = comparison > 0 ? current->leftChild : current->rightChild;
+            }
+            return bound;
+        }
+        /*
+        For each in range function calls the visit function on every value between low and high, inclusive of both, in ascending order. Nodes have no parent
+        links, so the walk keeps the path to the current node on a stack, skipping subtrees that lie wholly outside the range. In order visits every value.
+
+        @param[in]: The low and high ends of the range, and the function to call on each value.
+        @return: Nothing. Visits every value in the range.
+        */
+        template <typename VISIT>
+        void forEachInRange(const DATA_TYPE& low, const DATA_TYPE& high, VISIT visit) const
+        {
+            vector<PersistentNode*> path;
+            PersistentNode* current = version->root.get();
+            while (current || !path.empty())
+            {
+                while (current)
+                {
+                    if (compare(current->nodeValue, low) < 0)
+                    {
+                        current = current->rightChild;
+                        continue;
+                    }
+                    path.push_back(current);
+                    current = current->leftChild;
+                }
+                if (path.empty())
+                    break;
+                current = path.back();
+                path.pop_back();
+                if (compare(current->nodeValue, high) > 0)
+                    return;
+                visit(current->nodeValue);
+                current = current->rightChild;
+            }
+        }
+        template <typename VISIT>
+        void inOrder(VISIT visit) const
+        {
+            vector<PersistentNode*> path;
+            for (PersistentNode* current = version->root.get(); current || !path.empty();)
+            {
+                for (; current; current = current->leftChild)
+                    path.push_back(current);
+                current = path.back();
+                path.pop_back();
+                visit(current->nodeValue);
+                current = current->rightChild;
+            }
+        }
+    };
+
+private:
+    //Versions retired by writes are released once in this many, after the readers that might be taking a snapshot of them have finished.
+    static const size_t RECLAIM_THRESHOLD = 64;
+
+    mutable ReaderEpochs epochs;
+    atomic<Version*> current;
+    mutex writeMutex;
+    Compare compare;
+    WriteStats lastWrite;
+    WriteStats totalWrites;
+    size_t writeCopies = 0;
+
+    //Private function declarations.
+    template <typename VALUE>
+    NodeHandle makeNode(VALUE&& value, const NodeHandle& left, const NodeHandle& right);
+    template <typename VALUE>
+    NodeHandle balance(VALUE&& value, const NodeHandle& left, const NodeHandle& right);
+    NodeHandle insertNode(const NodeHandle& node, const DATA_TYPE& item, bool& inserted);
+    NodeHandle removeNode(const NodeHandle& node, const DATA_TYPE& item, bool& removed);
+    NodeHandle removeLargest(const NodeHandle& node, const DATA_TYPE*& largest);
+    void publish(Version* previous, NodeHandle root, int nodeCount);
+
+    static int getHeight(const NodeHandle& node)
+    {
+        return node ? node->treeHeight : 0;
+    }
+
+public:
+    PersistentBinarySearchTree(Compare cmp = defaultCompare<Compare>()) : current(new Version(NodeHandle(), 0, 0)), compare(cmp) {}
+    PersistentBinarySearchTree(const PersistentBinarySearchTree&) = delete;
+    PersistentBinarySearchTree& operator=(const PersistentBinarySearchTree&) = delete;
+    ~PersistentBinarySearchTree()
+    {
+        Version::release(current.load());
+    }
+
+    /*
+    Snapshot function takes the current version for reading. It registers with the epochs only for the moment it takes to load the version and add a reference,
+    so no lock is taken and a writer never waits on a long scan.
+
+    @param[in]: Nothing.
+    @return: A snapshot of the current version.
+    */
+    Snapshot snapshot() const
+    {
+        unsigned long long registered = epochs.enter();
+        Version* version = current.load(memory_order_acquire);
+        version->references.fetch_add(1, memory_order_relaxed);
+        epochs.leave(registered);
+        return Snapshot(version, compare);
+    }
+
+    bool tryInsert(const DATA_TYPE& item);
+    bool tryRemove(const DATA_TYPE& item);
+    /*
+    Insert and remove functions are the throwing versions of tryInsert and tryRemove, matching BinarySearchTree.
+
+    @param[in]: The item to insert or remove.
+    @return: A new version of the tree, or an exception if the item was a duplicate or was not found.
+    */
+    void insert(const DATA_TYPE& item)
+    {
+        if (!tryInsert(item))
+            throw DuplicateItemException(__LINE__, "Duplicate item detected. Unable to insert");
+    }
+    void remove(const DATA_TYPE& item)
+    {
+        if (!tryRemove(item))
+            throw ItemNotFoundException(__LINE__, "Item was not found");
+    }
+    /*
+    Count function returns the number of values in the current version.
+
+    @param[in]: Nothing.
+    @return: The current number of values.
+    */
+    int count() const
+    {
+        return snapshot().count();
+    }
+    /*
+    Write stats functions report the memory overhead of copying: the nodes copied by the last write that changed the tree, and the totals over all writes.
+
+    @param[in]: Nothing.
+    @return: The write stats, read under the write mutex.
+    */
+    WriteStats lastWriteStats()
+    {
+        lock_guard<mutex> lock(writeMutex);
+        return lastWrite;
+    }
+    WriteStats totalWriteStats()
+    {
+        lock_guard<mutex> lock(writeMutex);
+        return totalWrites;
+    }
+};
+/*
+Try insert function builds a new version with the item added, copying the path from the root down to where the item is attached. Nothing is copied or published
+if the item already exists.
+
+@param[in]: The item to insert.
+@return: Whether the item was inserted.
+*/
+template <typename DATA_TYPE, typename Compare>
+bool PersistentBinarySearchTree<DATA_TYPE, Compare>::tryInsert(const DATA_TYPE& item)
+{
+    lock_guard<mutex> lock(writeMutex);
+    Version* previous = current.load(memory_order_relaxed);
+    writeCopies = 0;
+    bool inserted = false;
+    NodeHandle root = insertNode(previous->root, item, inserted);
+    if (inserted)
+        publish(previous, std::move(root), previous->nodeCount + 1);
+    return inserted;
+}
+/*
+Try remove function builds a new version without the item, copying the path from the root down to the removed node, and on down to its in-order predecessor when
+the node has two children.
+
+@param[in]: The item to remove.
+@return: Whether the item was removed.
+*/
+template <typename DATA_TYPE, typename Compare>
+bool PersistentBinarySearchTree<DATA_TYPE, Compare>::tryRemove(const DATA_TYPE& item)
+{
+    lock_guard<mutex> lock(writeMutex);
+    Version* previous = current.load(memory_order_relaxed);
+    writeCopies = 0;
+    bool removed = false;
+    NodeHandle root = removeNode(previous->root, item, removed);
+    if (removed)
+        publish(previous, std::move(root), previous->nodeCount - 1);
+    return removed;
+}
+/*
+Publish function makes a new root the current version with a single atomic store, records the copies made by the write, and retires the tree's reference to the
+previous version. Snapshots already holding the previous version keep it alive.
+
+@param[in]: The previous version, the new root, and the number of values under it.
+@return: The new version published.
+*/
+template <typename DATA_TYPE, typename Compare>
+void PersistentBinarySearchTree<DATA_TYPE, Compare>::publish(Version* previous, NodeHandle root, int nodeCount)
+{
+    current.store(new Version(std::move(root), nodeCount, previous->number + 1), memory_order_release);
+    epochs.retire(previous, &Version::release);
+
+    lastWrite.writes = 1;
+    lastWrite.nodesCopied = writeCopies;
+    lastWrite.bytesCopied = writeCopies * sizeof(PersistentNode);
+    totalWrites.writes++;
+    totalWrites.nodesCopied += lastWrite.nodesCopied;
+    totalWrites.bytesCopied += lastWrite.bytesCopied;
+
+    if (epochs.retiredCount() >= RECLAIM_THRESHOLD)
+        epochs.reclaim();
+}
+/*
+Make node function builds a new node over two existing subtrees, taking references to them, and counts the copy against the current write.
+
+@param[in]: The value for the node, and its left and right subtrees.
+@return: A handle to the new node.
+*/
+template <typename DATA_TYPE, typename Compare>
+template <typename VALUE>
+typename PersistentBinarySearchTree<DATA_TYPE, Compare>::NodeHandle
+PersistentBinarySearchTree<DATA_TYPE, Compare>::makeNode(VALUE&& value, const NodeHandle& left, const NodeHandle& right)
+{
+    PersistentNode* node = new PersistentNode(std::forward<VALUE>(value), 1 + max(getHeight(left), getHeight(right)), left.get(), right.get());
+    if (left)
+        left->references.fetch_add(1, memory_order_relaxed);
+    if (right)
+        right->references.fetch_add(1, memory_order_relaxed);
+    writeCopies++;
+    return NodeHandle(node);
+}
+/*
+Balance function builds the node for a value over two subtrees whose heights differ by at most two, rotating when they differ by two. Rotations cannot change
+nodes in place, so the nodes they rearrange are rebuilt, using the same single and double rotation cases as insertRebalance and removeRebalance.
+
+@param[in]: The value for the node, and its new left and right subtrees.
+@return: A handle to the root of the balanced subtree.
+*/
+template <typename DATA_TYPE, typename Compare>
+template <typename VALUE>
+typename PersistentBinarySearchTree<DATA_TYPE, Compare>::NodeHandle
+PersistentBinarySearchTree<DATA_TYPE, Compare>::balance(VALUE&& value, const NodeHandle& left, const NodeHandle& right)
+{
+    int leftHeight = getHeight(left);
+    int rightHeight = getHeight(right);
+    if (leftHeight > rightHeight + 1)
+    {
+        NodeHandle leftleftChild(left->leftChild);
+        NodeHandle leftrightChild(left->rightChild);
+        if (getHeight(leftleftChild) >= getHeight(leftrightChild))
+            return makeNode(left->nodeValue, leftleftChild, makeNode(std::forward<VALUE>(value), leftrightChild, right));
+        return makeNode(leftrightChild->nodeValue, makeNode(left->nodeValue, leftleftChild, NodeHandle(leftrightChild->leftChild)),
+            makeNode(std::forward<VALUE>(value), NodeHandle(leftrightChild->rightChild), right));
+    }
+    if (rightHeight > leftHeight + 1)
+    {
+        NodeHandle rightrightChild(right->rightChild);
+        NodeHandle rightleftChild(right->leftChild);
+        if (getHeight(rightrightChild) >= getHeight(rightleftChild))
+            return makeNode(right->nodeValue, makeNode(std::forward<VALUE>(value), left, rightleftChild), rightrightChild);
+        return makeNode(rightleftChild->nodeValue, makeNode(std::forward<VALUE>(value), left, NodeHandle(rightleftChild->leftChild)),
+            makeNode(right->nodeValue, NodeHandle(rightleftChild->rightChild), rightrightChild));
+    }
+    return makeNode(std::forward<VALUE>(value), left, right);
+}
+/*
+Insert node function returns a subtree with the item added, copying each node on the way down. The existing subtree is returned unchanged, with nothing copied,
+when the item is already present.
+
+@param[in]: The root of the subtree, the item, and where to report whether it was inserted.
+@return: A handle to the root of the new subtree.
+*/
+template <typename DATA_TYPE, typename Compare>
+typename PersistentBinarySearchTree<DATA_TYPE, Compare>::NodeHandle
+PersistentBinarySearchTree<DATA_TYPE, Compare>::insertNode(const NodeHandle& node, const DATA_TYPE& item, bool& inserted)
+{
+    if (!node)
+    {
+        inserted = true;
+        return makeNode(item, NodeHandle(), NodeHandle());
+    }
+    int comparison = compare(node->nodeValue, item);
+    if (!comparison)
+        return node;
+    if (comparison > 0)
+    {
+        NodeHandle left = insertNode(NodeHandle(node->leftChild), item, inserted);
+        return inserted ? balance(node->nodeValue, left, NodeHandle(node->rightChild)) : node;
+    }
+    NodeHandle right = insertNode(NodeHandle(node->rightChild), item, inserted);
+    return inserted ? balance(node->nodeValue, NodeHandle(node->leftChild), right) : node;
+}
+/*
+Remove node function returns a subtree without the item. A node with two children is rebuilt with the value of its in-order predecessor, which is removed from
+the left subtree, as removeNode does for the mutable tree.
+
+@param[in]: The root of the subtree, the item, and where to report whether it was removed.
+@return: A handle to the root of the new subtree.
+*/
+template <typename DATA_TYPE, typename Compare>
+typename PersistentBinarySearchTree<DATA_TYPE, Compare>::NodeHandle
+PersistentBinarySearchTree<DATA_TYPE, Compare>::removeNode(const NodeHandle& node, const DATA_TYPE& item, bool& removed)
+{
+    if (!node)
+        return node;
+    int comparison = compare(node->nodeValue, item);
+    if (comparison > 0)
+    {
+        NodeHandle left = removeNode(NodeHandle(node->leftChild), item, removed);
+        return removed ? balance(node->nodeValue, left, NodeHandle(node->rightChild)) : node;
+    }
+    if (comparison < 0)
+    {
+        NodeHandle right = removeNode(NodeHandle(node->rightChild), item, removed);
+        return removed ? balance(node->nodeValue, NodeHandle(node->leftChild), right) : node;
+    }
+
+    removed = true;
+    if (!node->leftChild)
+        return NodeHandle(node->rightChild);
+    if (!node->rightChild)
+        return NodeHandle(node->leftChild);
+    const DATA_TYPE* predecessor = nullptr;
+    NodeHandle left = removeLargest(NodeHandle(node->leftChild), predecessor);
+    return balance(*predecessor, left, NodeHandle(node->rightChild));
+}
+/*
+Remove largest function returns a subtree without its largest value, and reports that value. The value lives in a node of the previous version, which stays
+alive for the whole write.
+
+@param[in]: The root of the subtree, which must not be empty, and where to report the largest value.
+@return: A handle to the root of the new subtree.
+*/
+template <typename DATA_TYPE, typename Compare>
+typename PersistentBinarySearchTree<DATA_TYPE, Compare>::NodeHandle
+PersistentBinarySearchTree<DATA_TYPE, Compare>::removeLargest(const NodeHandle& node, const DATA_TYPE*& largest)
+{
+    if (!node->rightChild)
+    {
+        largest = &node->nodeValue;
+        return NodeHandle(node->leftChild);
+    }
+    NodeHandle right = removeLargest(NodeHandle(node->rightChild), largest);
+    return balance(node->nodeValue, NodeHandle(node->leftChild), right);
+}
@@ -0,0 +1,342 @@
+/*
+@filename: AVL Sharded Search Tree Template Class
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the ShardedAVL class, a thread safe container that splits its keys by range across several independent BinarySearchTree
+shards, each behind its own shared_mutex. A single tree serializes every write at its root, since any insert or remove may rotate all the way up, however
+it is locked. Writes to different shards take different locks and touch different nodes, so they proceed in parallel.
+
+Shard i holds the values from boundary i - 1 up to, but not including, boundary i. Because the shards cover ascending, disjoint ranges, ordered iteration merges
+them by visiting them in turn. When a write leaves one shard holding well over its share of the values, the boundaries are recomputed and the values dealt
+out again evenly, so sequential or clustered keys do not leave all the writers queued on one shard.
+
+Compilation Instructions:
+    Header only. Include after or instead of AVLTemplateClass.h, and link with -pthread on Linux.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+
+/*
+Sharded AVL class holds the shards and the boundaries between them. Operations take a shared lock on the layout, then the lock of the one shard their key falls
+in. Rebalancing takes the layout lock exclusively, which waits for the operations in flight and holds off new ones while the values are dealt out again.
+
+@param[in]: The DATA_TYPE of the values, which must be copyable, the compare policy, and the allocator given to each shard's tree.
+@return: A range sharded AVL container.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>, typename Allocator = allocator<DATA_TYPE>>
+class ShardedAVL
+{
+    using Tree = BinarySearchTree<DATA_TYPE, Compare, Allocator>;
+
+    /*
+    Shard struct holds one tree, its lock, and its size, which is kept in an atomic so the skew check can read every shard without locking them. Each shard
+    starts on its own cache line, so writers to neighboring shards do not contend for one.
+    */
+    struct alignas(64) Shard
+    {
+        mutable shared_mutex shardMutex;
+        Tree tree;
+        atomic<int> size{ 0 };
+
+        Shard(const Compare& cmp, const Allocator& alloc) : tree(cmp, alloc) {}
+    };
+
+    //The fewest values a shard holds before skew is checked at all, and the skew allowed, as a shard holding more than SKEW_NUMERATOR / SKEW_DENOMINATOR
+    //times its even share of the values.
+    static const int REBALANCE_MINIMUM = 1024;
+    static const int SKEW_NUMERATOR = 3;
+    static const int SKEW_DENOMINATOR = 2;
+
+    mutable shared_mutex layoutMutex;
+    vector<unique_ptr<Shard>> shards;
+    //Boundary i is the smallest value shard i + 1 may hold. There may be fewer boundaries than shards, leaving the last shards unused.
+    vector<DATA_TYPE> boundaries;
+    atomic<int> rebalanceLimit{ REBALANCE_MINIMUM };
+    size_t rebalances = 0;
+    Compare compare;
+    Allocator shardAllocator;
+
+    //Private function declarations.
+    size_t shardFor(const DATA_TYPE& item) const;
+    template <typename WRITE>
+    bool write(const DATA_TYPE& item, WRITE writeTree);
+    void rebalanceIfSkewed();
+    void repartition();
+
+public:
+    /*
+    Constructor creates an empty container with a fixed number of shards, by default one per hardware thread. All values go to the first shard until it holds
+    enough to be split.
+
+    @param[in]: The number of shards, the compare policy instance, and the allocator instance.
+    @return: An empty sharded container.
+    */
+    ShardedAVL(int shardCount = (int)max(1u, thread::hardware_concurrency()), Compare cmp = defaultCompare<Compare>(), const Allocator& alloc = Allocator())
+        : compare(cmp), shardAllocator(alloc)
+    {
+        for (int i = 0; i < max(1, shardCount); i++)
+            shards.push_back(make_unique<Shard>(compare, shardAllocator));
+    }
+    ShardedAVL(const ShardedAVL&) = delete;
+    ShardedAVL& operator=(const ShardedAVL&) = delete;
+
+    /*
+    Write functions behave like their BinarySearchTree counterparts, holding the lock of one shard exclusively while they run.
+
+    @param[in]: The item to insert or remove.
+    @return: For the try functions, whether the container changed. Insert and remove throw as the tree does.
+    */
+    bool tryInsert(const DATA_TYPE& item)
+    {
+        return write(item, [&item](Tree& tree) { return tree.tryInsert(item).second; });
+    }
+    bool tryRemove(const DATA_TYPE& item)
+    {
+        return write(item, [&item](Tree& tree) { return tree.tryRemove(item); });
+    }
+    void insert(const DATA_TYPE& item)
+    {
+        if (!tryInsert(item))
+            throw DuplicateItemException(__LINE__, "Duplicate item detected. Unable to insert");
+    }
+    void remove(const DATA_TYPE& item)
+    {
+        if (!tryRemove(item))
+            throw ItemNotFoundException(__LINE__, "Item was not found");
+    }
+    /*
+    Find, contains, and search functions look up an item in the one shard that could hold it. Find returns a copy of the stored value if there is one, and
+    search throws when there is not.
+
+    @param[in]: The item to look up.
+    @return: A copy of the stored value, whether it exists, or an exception if it does not.
+    */
+    optional<DATA_TYPE> find(const DATA_TYPE& item) const
+    {
+        shared_lock<shared_mutex> layout(layoutMutex);
+        const Shard& shard = *shards[shardFor(item)];
+        shared_lock<shared_mutex> lock(shard.shardMutex);
+        const DATA_TYPE* value = shard.tree.find(item);
+        return value ? optional<DATA_TYPE>(*value) : nullopt;
+    }
+    bool contains(const DATA_TYPE& item) const
+    {
+        return find(item).has_value();
+    }
+    DATA_TYPE search(const DATA_TYPE& item) const
+    {
+        optional<DATA_TYPE> result = find(item);
+        if (!result)
+            throw ItemNotFoundException(__LINE__, "Item was not found");
+        return std::move(*result);
+    }
+    template <typename VISIT>
+    void forEachInRange(const DATA_TYPE& low, const DATA_TYPE& high, VISIT visit) const;
+    template <typename VISIT>
+    void inOrder(VISIT visit) const;
+    /*
+    Count function returns the number of values over all shards. Writes running at the same time may or may not be counted.
+
+    @param[in]: Nothing.
+    @return: The current number of values.
+    */
+    int count() const
+    {
+        shared_lock<shared_mutex> layout(layoutMutex);
+        int total = 0;
+        for (const unique_ptr<Shard>& shard : shards)
+            total += shard->size.load(memory_order_relaxed);
+        return total;
+    }
+    /*
+    Shard sizes and rebalance count functions report how the values are spread, for tests and benchmarks.
+
+    @param[in]: Nothing.
+    @return: The number of values in each shard, or the number of times the values have been dealt out again.
+    */
+    vector<int> shardSizes() const
+    {
+        shared_lock<shared_mutex> layout(layoutMutex);
+        vector<int> sizes;
+        for (const unique_ptr<Shard>& shard : shards)
+            sizes.push_back(shard->size.load(memory_order_relaxed));
+        return sizes;
+    }
+    size_t rebalanceCount() const
+    {
+        shared_lock<shared_mutex> layout(layoutMutex);
+        return rebalances;
+    }
+    /*
+    Rebalance function deals the values out evenly across the shards now, rather than waiting for a write to find a shard skewed. This is useful after many
+    removes have emptied some shards, which the write path does not check for.
+
+    @param[in]: Nothing.
+    @return: Nothing. The shards hold equal shares of the values.
+    */
+    void rebalance()
+    {
+        unique_lock<shared_mutex> layout(layoutMutex);
+        repartition();
+    }
+};
+/*
+Shard for function finds the shard whose range holds an item, by binary search over the boundaries. The layout lock must be held.
+
+@param[in]: The item to place.
+@return: The index of the shard for the item.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+size_t ShardedAVL<DATA_TYPE, Compare, Allocator>::shardFor(const DATA_TYPE& item) const
+{
+    return upper_bound(boundaries.begin(), boundaries.end(), item, [this](const DATA_TYPE& item1, const DATA_TYPE& item2) { return compare(item1, item2) < 0; })
+        - boundaries.begin();
+}
+/*
+Write function runs a change on the shard for an item under that shard's exclusive lock, then updates the shard's size. If the shard has grown past the limit,
+the skew check runs once the locks are released.
+
+@param[in]: The item being written, and the function making the change to the shard's tree.
+@return: Whether the change was made.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+template <typename WRITE>
+bool ShardedAVL<DATA_TYPE, Compare, Allocator>::write(const DATA_TYPE& item, WRITE writeTree)
+{
+    bool changed = false;
+    bool overLimit = false;
+    {
+        shared_lock<shared_mutex> layout(layoutMutex);
+        Shard& shard = *shards[shardFor(item)];
+        unique_lock<shared_mutex> lock(shard.shardMutex);
+        changed = writeTree(shard.tree);
+        int size = shard.tree.count();
+        shard.size.store(size, memory_order_relaxed);
+        overLimit = size > rebalanceLimit.load(memory_order_relaxed);
+    }
+    if (overLimit)
+        rebalanceIfSkewed();
+    return changed;
+}
+/*
+Rebalance if skewed function takes the layout lock exclusively and checks whether the largest shard holds more than the allowed multiple of its share. If it
+does, the values are dealt out again. Either way the limit is raised to that multiple of the current share, so shards that grow evenly are not checked again
+until they have grown by half.
+
+@param[in]: Nothing.
+@return: Nothing. The shards are rebalanced if they were skewed.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void ShardedAVL<DATA_TYPE, Compare, Allocator>::rebalanceIfSkewed()
+{
+    unique_lock<shared_mutex> layout(layoutMutex);
+    long long total = 0;
+    int largest = 0;
+    for (const unique_ptr<Shard>& shard : shards)
+    {
+        int size = shard->size.load(memory_order_relaxed);
+        total += size;
+        largest = max(largest, size);
+    }
+    if (largest <= rebalanceLimit.load(memory_order_relaxed))
+        return;
+    if ((long long)largest * (long long)shards.size() * SKEW_DENOMINATOR > total * SKEW_NUMERATOR)
+        repartition();
+    else
+        rebalanceLimit.store(max((long long)REBALANCE_MINIMUM, total * SKEW_NUMERATOR / (SKEW_DENOMINATOR * (long long)shards.size())), memory_order_relaxed);
+}
+/*
+Repartition function copies every value out in order, builds new shards holding equal consecutive slices with assignSorted, and only then swaps them in, so an
+allocation failure leaves the old shards as they were. The layout lock must be held exclusively, which also means no shard lock is held.
+
+@param[in]: Nothing.
+@return: Nothing. The shards hold equal shares of the values, and the boundaries and limit match them.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+void ShardedAVL<DATA_TYPE, Compare, Allocator>::repartition()
+{
+    vector<DATA_TYPE> values;
+    for (const unique_ptr<Shard>& shard : shards)
+        values.insert(values.end(), shard->tree.begin(), shard->tree.end());
+
+    size_t shardCount = shards.size();
+    vector<unique_ptr<Shard>> newShards;
+    vector<DATA_TYPE> newBoundaries;
+    for (size_t i = 0; i < shardCount; i++)
+    {
+        //Slices are empty only when there are fewer values than shards. Those shards are left empty at the end, so each used shard follows its boundary.
+        size_t first = values.size() * i / shardCount;
+        size_t last = values.size() * (i + 1) / shardCount;
+        if (first == last)
+            continue;
+        if (!newShards.empty())
+            newBoundaries.push_back(values[first]);
+        newShards.push_back(make_unique<Shard>(compare, shardAllocator));
+        newShards.back()->tree.assignSorted(make_move_iterator(values.begin() + first), make_move_iterator(values.begin() + last));
+        newShards.back()->size.store((int)(last - first), memory_order_relaxed);
+    }
+    while (newShards.size() < shardCount)
+        newShards.push_back(make_unique<Shard>(compare, shardAllocator));
+
+    shards.swap(newShards);
+    boundaries.swap(newBoundaries);
+    rebalanceLimit.store(max((long long)REBALANCE_MINIMUM, (long long)values.size() * SKEW_NUMERATOR / (SKEW_DENOMINATOR * (long long)shardCount)),
+        memory_order_relaxed);
+    rebalances++;
+}
+/*
+For each in range function calls the visit function on every value between low and high, inclusive of both, in ascending order. Only the shards overlapping
+the range are read, each under its shared lock in turn, and the values are copied out so the visit function runs without any lock held.
+
+@param[in]: The low and high ends of the range, and the function to call on each value.
+@return: Nothing. Visits every value in the range.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+template <typename VISIT>
+void ShardedAVL<DATA_TYPE, Compare, Allocator>::forEachInRange(const DATA_TYPE& low, const DATA_TYPE& high, VISIT visit) const
+{
+    vector<DATA_TYPE> values;
+    {
+        shared_lock<shared_mutex> layout(layoutMutex);
+        if (compare(low, high) > 0)
+            return;
+        for (size_t i = shardFor(low), last = shardFor(high); i <= last; i++)
+        {
+            shared_lock<shared_mutex> lock(shards[i]->shardMutex);
+            shards[i]->tree.forEachInRange(low, high, [&values](const DATA_TYPE& value) { values.push_back(value); });
+        }
+    }
+    for (const DATA_TYPE& value : values)
+        visit(value);
+}
+/*
+In order function calls the visit function on every value in ascending order, reading the shards one after another.
+
+@param[in]: The function to call on each value.
+@return: Nothing. Visits every value.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator>
+template <typename VISIT>
+void ShardedAVL<DATA_TYPE, Compare, Allocator>::inOrder(VISIT visit) const
+{
+    vector<DATA_TYPE> values;
+    {
+        shared_lock<shared_mutex> layout(layoutMutex);
+        for (const unique_ptr<Shard>& shard : shards)
+        {
+            shared_lock<shared_mutex> lock(shard->shardMutex);
+            values.insert(values.end(), shard->tree.begin(), shard->tree.end());
+        }
+    }
+    for (const DATA_TYPE& value : values)
+        visit(value);
+}
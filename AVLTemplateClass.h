@@ -21,11 +21,43 @@ Compilation Instructions:
 #include <string>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace std;
 using std::string;
 using std::stringstream;
 
+//Defining AVL_TREE_STATS before including this file turns on the tree's instrumentation counters. Without it the counting statements compile to nothing.
+#ifdef AVL_TREE_STATS
+#define AVL_TOUCH_NODES(count) (touchedNodes.add(count))
+#define AVL_COUNT_STAT(counter) (counter.add(1))
+#define AVL_RECORD_DESCENT(depth) (recordDescent(depth))
+#else
+#define AVL_TOUCH_NODES(count) ((void)0)
+#define AVL_COUNT_STAT(counter) ((void)0)
+#define AVL_RECORD_DESCENT(depth) ((void)(depth))
+#endif
+
+//Prefetch hint for memory a search is about to read. It never faults, so the address may lie outside the data.
+#if defined(__GNUC__) || defined(__clang__)
+#define AVL_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define AVL_PREFETCH(address) _mm_prefetch((const char*)(address), _MM_HINT_T0)
+#else
+#define AVL_PREFETCH(address) ((void)0)
+#endif
+
 /*
 General exception class serves as template for specific exceptions that may occur within the program. Holds protected variables for exception info and 
 the output string for an exception.
@@ -101,354 +133,2574 @@ public:
     }
 };
 /*
-Massive Binary Search Tree class contains all the public and private information needed to create, manipulate, and delete a tree and its nodes. Each function and 
-class contains a description of its role in the program.
+Unsorted input exception inherits from the general exception class and reports that a range given to a bulk load was not in strictly ascending order.
 
-@param[in]: Constructor takes function pointer to compare function in main.
-@return: An AVL balancing binary search tree object able to be used by class functions.
+@param[in]: Inherited info on error from Exception class.
+@return: Text output stating unsorted input error has occurred.
+*/
+class UnsortedInputException : public Exception
+{
+public:
+    UnsortedInputException(int eNo, string msg) : Exception(eNo, msg) {}
+    string toString()
+    {
+        stringstream sstream;
+        sstream << "UnsortedInputException: " << errorNumber << " ERROR: " << message;
+        return sstream.str();
+    }
+};
+/*
+Invalid tree exception inherits from the general exception class and reports that validate found a broken invariant in the structure of a tree.
+
+@param[in]: Inherited info on error from Exception class.
+@return: Text output stating which invariant of the tree is broken.
+*/
+class InvalidTreeException : public Exception
+{
+public:
+    InvalidTreeException(int eNo, string msg) : Exception(eNo, msg) {}
+    string toString()
+    {
+        stringstream sstream;
+        sstream << "InvalidTreeException: " << errorNumber << " ERROR: " << message;
+        return sstream.str();
+    }
+};
+/*
+Three way compare functor is the default comparison policy of the tree. It returns -1, 0, or 1 based on the comparison of two items using operator<, and
+because it is a type rather than a function pointer, the compiler is able to inline every comparison made while descending the tree.
+
+@param[in]: Two DATA_TYPE items to be compared.
+@return: -1, 0, or 1 based on the comparison of the inputs.
+*/
+template <typename DATA_TYPE = void>
+struct ThreeWayCompare
+{
+    int operator()(const DATA_TYPE& item1, const DATA_TYPE& item2) const
+    {
+        if (item1 < item2)
+            return -1;
+        if (item2 < item1)
+            return 1;
+        return 0;
+    }
+};
+/*
+String specialization of the three way compare functor uses string::compare so that each comparison walks the characters only once instead of twice.
+
+@param[in]: Two strings to be compared.
+@return: -1, 0, or 1 based on the comparison of the inputs.
+*/
+template <>
+struct ThreeWayCompare<string>
+{
+    int operator()(const string& item1, const string& item2) const
+    {
+        int result = item1.compare(item2);
+        return (result > 0) - (result < 0);
+    }
+};
+/*
+Transparent specialization of the three way compare functor, written ThreeWayCompare<>, compares two items of any types that can be compared with operator<. A tree
+using it accepts lookup keys of other types, such as a string_view probing a tree of strings, without converting the key on every comparison.
+
+@param[in]: Two items to be compared.
+@return: -1, 0, or 1 based on the comparison of the inputs.
+*/
+template <>
+struct ThreeWayCompare<void>
+{
+    using is_transparent = void;
+
+    template <typename FIRST_TYPE, typename SECOND_TYPE>
+    int operator()(const FIRST_TYPE& item1, const SECOND_TYPE& item2) const
+    {
+        if (item1 < item2)
+            return -1;
+        if (item2 < item1)
+            return 1;
+        return 0;
+    }
+};
+/*
+Compare function alias names the runtime function pointer type the tree originally took. Passing it as the Compare parameter keeps the old indirect call behavior
+available, e.g. BinarySearchTree<int, CompareFunction<int>> tree(compare).
 */
 template <typename DATA_TYPE>
-class BinarySearchTree
+using CompareFunction = int (*)(const DATA_TYPE& item1, const DATA_TYPE& item2);
+/*
+Default compare function gives the compare policy instance a container uses when none is passed. Functor types are default constructed, but a function pointer
+has nothing to default to and would be null until the first comparison crashed, so a CompareFunction container must be given its function.
+
+@param[in]: Nothing.
+@return: A default constructed compare policy, or a compile error if the policy is a function pointer.
+*/
+template <typename Compare>
+Compare defaultCompare()
+{
+    static_assert(!is_pointer<Compare>::value, "A CompareFunction container must be constructed with its compare function");
+    return Compare();
+}
+/*
+Tree stats struct is a snapshot of a tree's instrumentation counters, returned by stats() when AVL_TREE_STATS is defined. Descents are the walks down from the root
+by findParentOrDuplicate behind every search, insert, and remove. descentDepths counts them by the number of nodes each visited, with the last bucket also
+holding any deeper ones. The fields are plain numbers, so a snapshot can be copied and exported as it is.
+*/
+struct TreeStats
 {
+    static const int DEPTH_BUCKETS = 48;
+
+    long long comparisons = 0;
+    long long leftRotations = 0;
+    long long rightRotations = 0;
+    long long insertRebalances = 0;
+    long long removeRebalances = 0;
+    long long descents = 0;
+    long long descentNodes = 0;
+    long long nodesTouched = 0;
+    long long descentDepths[DEPTH_BUCKETS] = {};
+
     /*
-    Binary tree node class serves to identify the information held in each node of the tree, such as value assigned to it and its height. This also includes 
-    pointers to the parent node, and left and right children.
+    Descent depth functions summarize the histogram as the mean depth, and the depth that the given fraction of descents, such as 0.99, did not exceed.
+
+    @param[in]: Nothing, or the fraction of descents between 0 and 1.
+    @return: The mean depth, or the depth at the fraction.
+    */
+    double averageDescentDepth() const
+    {
+        return descents ? (double)descentNodes / descents : 0;
+    }
+    int descentDepthPercentile(double fraction) const
+    {
+        long long seen = 0;
+        for (int depth = 0; depth < DEPTH_BUCKETS; depth++)
+        {
+            seen += descentDepths[depth];
+            if (seen > 0 && seen >= fraction * descents)
+                return depth;
+        }
+        return DEPTH_BUCKETS - 1;
+    }
+};
+#ifdef AVL_TREE_STATS
+/*
+Tree stat counter struct is one instrumentation counter. It counts with relaxed atomic loads and stores rather than an atomic increment, so lookups running
+together under a shared lock stay free of data races without paying for a locked instruction, at the cost of now and then losing a count when two threads bump
+the same counter at once. Copies take the current count.
+*/
+struct TreeStatCounter
+{
+    atomic<long long> value{0};
+
+    TreeStatCounter() = default;
+    TreeStatCounter(const TreeStatCounter& other) : value(other.get()) {}
+    TreeStatCounter& operator=(const TreeStatCounter& other)
+    {
+        value.store(other.get(), memory_order_relaxed);
+        return *this;
+    }
+    void add(long long count)
+    {
+        value.store(value.load(memory_order_relaxed) + count, memory_order_relaxed);
+    }
+    long long get() const
+    {
+        return value.load(memory_order_relaxed);
+    }
+    void reset()
+    {
+        value.store(0, memory_order_relaxed);
+    }
+};
+/*
+Counting compare class stands in for the tree's compare policy when AVL_TREE_STATS is defined, counting each call before passing it on. It converts back to the
+policy wherever the policy itself is needed.
+*/
+template <typename Compare>
+class CountedCompare
+{
+    Compare policy;
+
+public:
+    mutable TreeStatCounter calls;
+
+    CountedCompare(const Compare& cmp) : policy(cmp) {}
+    template <typename ITEM1, typename ITEM2>
+    int operator()(const ITEM1& item1, const ITEM2& item2) const
+    {
+        calls.add(1);
+        return policy(item1, item2);
+    }
+    operator const Compare&() const
+    {
+        return policy;
+    }
+};
+#endif
+/*
+Pool allocator class is a slab allocator for tree nodes. Single objects are handed out from contiguous blocks that grow geometrically, freed objects are
+recycled through an intrusive free list, and release returns every block at once. Copies of an allocator share the same pool, so nodes can be freed through
+any copy, while rebinding to another type starts a new pool since its slots have a different size. The pool is not thread safe.
+
+@param[in]: The type of object handed out by the allocator.
+@return: An allocator usable as the Allocator parameter of BinarySearchTree.
+*/
+template <typename DATA_TYPE>
+class PoolAllocator
+{
+    //A slot holds either a live object or the link to the next free slot.
+    union Slot
+    {
+        Slot* nextFree;
+        alignas(DATA_TYPE) unsigned char storage[sizeof(DATA_TYPE)];
+    };
 
-    @param[in]: Nothing. Nodes are created using new and delete.
-    @return: A tree node with pointers set to either null or the addresses of connected nodes, as well as node height and value.
+    /*
+    Pool class holds the blocks, the free list, and the bump pointer into the newest block. Blocks are returned to the system when the pool is destroyed.
     */
-    class BinaryTreeNode
+    class Pool
     {
     public:
-        DATA_TYPE nodeValue;
-        //Tree height represents subtree where a certain node is the root.
-        int treeHeight;
-        BinaryTreeNode* leftChild;
-        BinaryTreeNode* rightChild;
-        BinaryTreeNode* parent;
-
-        BinaryTreeNode() { parent = leftChild = rightChild = nullptr; }
+        vector<Slot*> blocks;
+        Slot* freeList = nullptr;
+        Slot* nextSlot = nullptr;
+        size_t slotsLeft = 0;
+        size_t nextBlockSlots = 64;
+
+        ~Pool()
+        {
+            releaseBlocks();
+        }
+        void releaseBlocks()
+        {
+            for (Slot* block : blocks)
+                ::operator delete(block, align_val_t(alignof(Slot)));
+            blocks.clear();
+            freeList = nextSlot = nullptr;
+            slotsLeft = 0;
+            nextBlockSlots = 64;
+        }
     };
 
-    BinaryTreeNode* root;
+    shared_ptr<Pool> pool;
+
+    template <typename OTHER_TYPE>
+    friend class PoolAllocator;
+
+public:
+    using value_type = DATA_TYPE;
+
+    PoolAllocator() : pool(make_shared<Pool>()) {}
+    template <typename OTHER_TYPE>
+    PoolAllocator(const PoolAllocator<OTHER_TYPE>&) : pool(make_shared<Pool>()) {}
+
+    DATA_TYPE* allocate(size_t n);
+    void deallocate(DATA_TYPE* object, size_t n);
+    /*
+    Release function frees every block of the pool in one pass without visiting the objects inside them. Any objects still living in the pool must have been
+    destroyed already, or be trivially destructible.
+
+    @param[in]: Nothing.
+    @return: An empty pool. Later allocations start new blocks.
+    */
+    void release()
+    {
+        pool->releaseBlocks();
+    }
+    /*
+    Unshared function reports whether this allocator is the only copy using its pool, which tells the tree it may release the pool when it is destroyed.
+
+    @param[in]: Nothing.
+    @return: True if no other allocator copy shares the pool.
+    */
+    bool unshared() const
+    {
+        return pool.use_count() == 1;
+    }
+
+    template <typename OTHER_TYPE>
+    bool operator==(const PoolAllocator<OTHER_TYPE>& other) const
+    {
+        return (const void*)pool.get() == (const void*)other.pool.get();
+    }
+    template <typename OTHER_TYPE>
+    bool operator!=(const PoolAllocator<OTHER_TYPE>& other) const
+    {
+        return !(*this == other);
+    }
+};
+/*
+Allocate function hands out a slot from the free list if one exists, otherwise from the newest block, starting a new block twice the size of the last one
+when the current block is used up. Requests for more than one object fall back to the global allocator.
+
+@param[in]: The number of objects to allocate.
+@return: Uninitialized storage for the objects.
+*/
+template <typename DATA_TYPE>
+DATA_TYPE* PoolAllocator<DATA_TYPE>::allocate(size_t n)
+{
+    if (n != 1)
+        return static_cast<DATA_TYPE*>(::operator new(n * sizeof(DATA_TYPE), align_val_t(alignof(DATA_TYPE))));
+
+    Pool& slab = *pool;
+    if (slab.freeList)
+    {
+        Slot* slot = slab.freeList;
+        slab.freeList = slot->nextFree;
+        return reinterpret_cast<DATA_TYPE*>(slot);
+    }
+    if (slab.slotsLeft == 0)
+    {
+        Slot* block = static_cast<Slot*>(::operator new(slab.nextBlockSlots * sizeof(Slot), align_val_t(alignof(Slot))));
+        slab.blocks.push_back(block);
+        slab.nextSlot = block;
+        slab.slotsLeft = slab.nextBlockSlots;
+        if (slab.nextBlockSlots < 65536)
+            slab.nextBlockSlots *= 2;
+    }
+    slab.slotsLeft--;
+    return reinterpret_cast<DATA_TYPE*>(slab.nextSlot++);
+}
+/*
+Deallocate function pushes a single object's slot onto the free list so the next allocation reuses it. Larger requests are returned to the global allocator.
+
+@param[in]: The storage being freed and the number of objects it held.
+@return: Nothing. The slot is available for reuse.
+*/
+template <typename DATA_TYPE>
+void PoolAllocator<DATA_TYPE>::deallocate(DATA_TYPE* object, size_t n)
+{
+    if (n != 1)
+    {
+        ::operator delete(object, align_val_t(alignof(DATA_TYPE)));
+        return;
+    }
+
+    Slot* slot = reinterpret_cast<Slot*>(object);
+    slot->nextFree = pool->freeList;
+    pool->freeList = slot;
+}
+/*
+Has bulk release trait detects allocators such as PoolAllocator that can free all of their memory at once, so the tree can skip freeing nodes one by one.
+*/
+template <typename ALLOCATOR, typename = void>
+struct HasBulkRelease : false_type {};
+template <typename ALLOCATOR>
+struct HasBulkRelease<ALLOCATOR, void_t<decltype(declval<ALLOCATOR&>().release()), decltype(declval<const ALLOCATOR&>().unshared())>> : true_type {};
+/*
+Has concurrent readers trait detects allocators that declare concurrent_readers, such as the RetiringAllocator of ConcurrentBinarySearchTree. Such an allocator
+delays freeing nodes until readers that take no lock are done with them, and the tree then stores its links in AtomicNodeLink so those readers can follow them
+while a writer changes them.
+*/
+template <typename ALLOCATOR, typename = void>
+struct HasConcurrentReaders : false_type {};
+template <typename ALLOCATOR>
+struct HasConcurrentReaders<ALLOCATOR, void_t<typename ALLOCATOR::concurrent_readers>> : ALLOCATOR::concurrent_readers {};
+/*
+Atomic node link class stands in for a node pointer when readers may follow links while a writer changes them. It converts to and from a plain pointer, so the
+tree code uses it exactly like one, but every read is an acquire load and every write a release store. A reader that sees a new link therefore also sees the
+node it leads to fully built. On x86 both compile to ordinary moves.
+
+@param[in]: The node type linked to.
+@return: A pointer-like link with atomic loads and stores.
+*/
+template <typename NODE>
+class AtomicNodeLink
+{
+    atomic<NODE*> link;
+
+public:
+    AtomicNodeLink(NODE* node = nullptr) : link(node) {}
+    AtomicNodeLink(const AtomicNodeLink& other) : link(other.load()) {}
+    AtomicNodeLink& operator=(NODE* node)
+    {
+        link.store(node, memory_order_release);
+        return *this;
+    }
+    AtomicNodeLink& operator=(const AtomicNodeLink& other)
+    {
+        return *this = other.load();
+    }
+    NODE* load() const
+    {
+        return link.load(memory_order_acquire);
+    }
+    operator NODE*() const
+    {
+        return load();
+    }
+    NODE* operator->() const
+    {
+        return load();
+    }
+};
+/*
+Subtree size field is a base of the tree node that holds the number of nodes in the subtree the node roots. It is empty unless order statistics are enabled, so
+trees that do not use select, rank, or countRange pay nothing for it.
+*/
+template <bool ORDER_STATISTICS>
+struct SubtreeSizeField {};
+template <>
+struct SubtreeSizeField<true>
+{
+    int subtreeSize = 1;
+};
+/*
+AVL tree node class serves to identify the information held in each node of a BinarySearchTree, such as value assigned to it and its height. This also includes
+pointers to the parent node, and left and right children.
+
+@param[in]: The value type, the order statistics flag, and whether the links are atomic for concurrent readers. Nodes are created and destroyed through the
+    tree's node allocator.
+@return: A tree node with pointers set to either null or the addresses of connected nodes, as well as node height and value.
+*/
+template <typename DATA_TYPE, bool ORDER_STATISTICS, bool ATOMIC_LINKS>
+class AVLTreeNode : public SubtreeSizeField<ORDER_STATISTICS>
+{
+public:
+    //Links are plain pointers, unless the allocator serves concurrent readers.
+    using Link = typename conditional<ATOMIC_LINKS, AtomicNodeLink<AVLTreeNode>, AVLTreeNode*>::type;
+
+    DATA_TYPE nodeValue;
+    //Tree height represents subtree where a certain node is the root.
+    int treeHeight;
+    Link leftChild;
+    Link rightChild;
+    Link parent;
+
+    template <typename... ARGS>
+    AVLTreeNode(ARGS&&... args) : nodeValue(std::forward<ARGS>(args)...), treeHeight(1) { parent = leftChild = rightChild = nullptr; }
+};
+/*
+AVL tree links class holds the linking and rebalancing code shared by the trees whose nodes carry parent links and heights: the rotations, the rebalance cases
+after insertion and deletion, and the walks that link a node in or unlink it and restore balance on the way up. BinarySearchTree derives from it for the nodes
+it allocates, and IntrusiveAVLTree (AVLIntrusiveTemplateClass.h) for hooks embedded in objects it does not own, so both run the same rebalancing code.
+
+The deriving tree passes itself as the first parameter, befriends this class, and keeps its root in a member named root. The node type needs leftChild,
+rightChild, parent, and treeHeight members, and subtreeSize as well when order statistics are enabled.
+
+@param[in]: The deriving tree class, its node type, and the order statistics flag.
+@return: A base class giving the tree its linking and rebalancing functions.
+*/
+template <typename TREE, typename NODE, bool ORDER_STATISTICS = false>
+class AVLTreeLinks
+{
+protected:
+#ifdef AVL_TREE_STATS
+    //Nodes visited by descents, height update walks, and rotations, and the rebalancing counters, kept only when AVL_TREE_STATS is defined.
+    mutable TreeStatCounter touchedNodes;
+    mutable TreeStatCounter leftRotations;
+    mutable TreeStatCounter rightRotations;
+    mutable TreeStatCounter insertRebalances;
+    mutable TreeStatCounter removeRebalances;
+#endif
+    /*
+    Tree function reaches the deriving tree, for its root.
+
+    @param[in]: Nothing.
+    @return: The tree this object is the base of.
+    */
+    TREE& tree()
+    {
+        return static_cast<TREE&>(*this);
+    }
+    const TREE& tree() const
+    {
+        return static_cast<const TREE&>(*this);
+    }
+    /*
+    Leftmost and rightmost node functions follow child pointers down one side of a subtree, finding its smallest or largest node.
+
+    @param[in]: The root of the subtree, which must not be null.
+    @return: The node holding the smallest or largest value of the subtree.
+    */
+    static NODE* leftmostNode(NODE* node)
+    {
+        while (node->leftChild)
+            node = node->leftChild;
+        return node;
+    }
+    static NODE* rightmostNode(NODE* node)
+    {
+        while (node->rightChild)
+            node = node->rightChild;
+        return node;
+    }
+    /*
+    Successor and predecessor node functions find the next or previous node in order using the parent pointers, so no stack or recursion is needed. Each step is
+    O(1) amortized over a full traversal, since every edge is walked at most twice.
+
+    @param[in]: The node to step from, which must not be null.
+    @return: The neighboring node in order, or null if the node is the last or first.
+    */
+    static NODE* successorNode(NODE* node)
+    {
+        if (node->rightChild)
+            return leftmostNode(node->rightChild);
+        while (node->parent && node->parent->rightChild == node)
+            node = node->parent;
+        return node->parent;
+    }
+    static NODE* predecessorNode(NODE* node)
+    {
+        if (node->leftChild)
+            return rightmostNode(node->leftChild);
+        while (node->parent && node->parent->leftChild == node)
+            node = node->parent;
+        return node->parent;
+    }
+    /*
+    Replace child function puts a new subtree in the place a child held under its parent, or at the root when there is no parent, and links the parent back.
+
+    @param[in]: The parent, possibly null, the child being replaced, and the new child, possibly null.
+    @return: Nothing. The tree links are updated.
+    */
+    void replaceChild(NODE* parentNode, NODE* oldChild, NODE* newChild)
+    {
+        if (!parentNode)
+            tree().root = newChild;
+        else if (parentNode->leftChild == oldChild)
+            parentNode->leftChild = newChild;
+        else
+            parentNode->rightChild = newChild;
+        if (newChild)
+            newChild->parent = parentNode;
+    }
+
+    void linkAndRebalance(NODE* parentNode, NODE* node, int lastComparison);
+    void unlinkAndRebalance(NODE* node);
+    void rotateRight(NODE* node);
+    void rotateLeft(NODE* node);
+    void insertRebalance(NODE* offBalanceNode, NODE* preNode, NODE* prepreNode);
+    NODE* removeRebalance(NODE* offbalanceNode);
+    static int getHeight(NODE* node);
+    template <typename ORDERED>
+    void validateLinks(int nodeCount, ORDERED ordered) const;
+    /*
+    Subtree height function reads the height kept in a node, treating a missing node as an empty subtree.
+
+    @param[in]: The node, possibly null.
+    @return: The height of the subtree.
+    */
+    static int subtreeHeight(NODE* node)
+    {
+        return node ? node->treeHeight : 0;
+    }
+    /*
+    Subtree size function reads the size kept in a node, treating a missing node as an empty subtree. Only used when order statistics are enabled.
+
+    @param[in]: The node whose subtree is measured, possibly null.
+    @return: The number of nodes in the subtree.
+    */
+    static int subtreeSize(NODE* node)
+    {
+        return node ? node->subtreeSize : 0;
+    }
+    /*
+    Update size function recalculates the subtree size of a node from its children, alongside the height updates. It does nothing when order statistics are disabled.
+
+    @param[in]: The node needing its size recalculated.
+    @return: Nothing. The node's subtree size is updated.
+    */
+    static void updateSize(NODE* node)
+    {
+        if constexpr (ORDER_STATISTICS)
+            node->subtreeSize = subtreeSize(node->leftChild) + subtreeSize(node->rightChild) + 1;
+    }
+    /*
+    Adjust sizes function adds a change to the subtree size of a node and every ancestor above it, used when a node is linked in or unlinked below them. It does
+    nothing when order statistics are disabled.
+
+    @param[in]: The lowest node whose subtree changed, possibly null, and the change in size.
+    @return: Nothing. The sizes on the path to the root are updated.
+    */
+    static void adjustSizes(NODE* node, int change)
+    {
+        if constexpr (ORDER_STATISTICS)
+        {
+            for (; node; node = node->parent)
+                node->subtreeSize += change;
+        }
+    }
+};
+//Read only snapshot returned by freeze(), defined in AVLFrozenTemplateClass.h.
+template <typename DATA_TYPE, typename Compare>
+class FrozenSearchTree;
+//Thread safe wrapper that reads the tree's nodes directly, defined in AVLConcurrentTemplateClass.h.
+template <typename DATA_TYPE, typename Compare>
+class ConcurrentBinarySearchTree;
+/*
+Massive Binary Search Tree class contains all the public and private information needed to create, manipulate, and delete a tree and its nodes. Each function and 
+class contains a description of its role in the program.
+
+@param[in]: Compare policy type, either a functor/lambda type returning a negative, zero, or positive int, or a CompareFunction pointer. Defaults to ThreeWayCompare.
+    Allocator type used for the nodes after rebinding, such as PoolAllocator. Defaults to allocator.
+    Order statistics flag, which keeps subtree sizes in the nodes to support select, rank, and countRange. Defaults to false.
+@return: An AVL balancing binary search tree object able to be used by class functions.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>, typename Allocator = allocator<DATA_TYPE>, bool ORDER_STATISTICS = false>
+class BinarySearchTree : AVLTreeLinks<BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>, AVLTreeNode<DATA_TYPE, ORDER_STATISTICS, HasConcurrentReaders<Allocator>::value>, ORDER_STATISTICS>
+{
+    using BinaryTreeNode = AVLTreeNode<DATA_TYPE, ORDER_STATISTICS, HasConcurrentReaders<Allocator>::value>;
+    using Links = AVLTreeLinks<BinarySearchTree, BinaryTreeNode, ORDER_STATISTICS>;
+    friend Links;
+    using Links::leftmostNode;
+    using Links::rightmostNode;
+    using Links::successorNode;
+    using Links::predecessorNode;
+    using Links::replaceChild;
+    using Links::rotateRight;
+    using Links::rotateLeft;
+    using Links::getHeight;
+    using Links::subtreeHeight;
+    using Links::subtreeSize;
+    using Links::updateSize;
+    using Links::adjustSizes;
+
+    using NodeAllocator = typename allocator_traits<Allocator>::template rebind_alloc<BinaryTreeNode>;
+    using NodeAllocatorTraits = allocator_traits<NodeAllocator>;
+    template <typename, typename>
+    friend class ConcurrentBinarySearchTree;
+
+    typename BinaryTreeNode::Link root;
     //NodeCount used for count function.
     int nodeCount;
 
     //Function declarations, and definitions for brief functions.
-    int (*compare)(const DATA_TYPE& item1, const DATA_TYPE& item2);
-    BinaryTreeNode* findParentOrDuplicate(const DATA_TYPE& item);
+#ifdef AVL_TREE_STATS
+    CountedCompare<Compare> compare;
+#else
+    Compare compare;
+#endif
+    NodeAllocator nodeAllocator;
+#ifdef AVL_TREE_STATS
+    //The counters behind stats(), kept only when AVL_TREE_STATS is defined. The rebalancing counters live in AVLTreeLinks.
+    using Links::touchedNodes;
+    using Links::leftRotations;
+    using Links::rightRotations;
+    using Links::insertRebalances;
+    using Links::removeRebalances;
+    mutable TreeStatCounter descents;
+    mutable TreeStatCounter descentNodes;
+    mutable TreeStatCounter descentDepths[TreeStats::DEPTH_BUCKETS];
     /*
-    Private inorder function carries out the processs of doing an inOrder tree traversal, and is used for findParentorDuplicate function.
+    Record descent function counts one descent and the nodes it visited.
 
-    @param[in]: Node object used to visit various nodes until node doesn't exist, as well as a function pointer to visit to get a value.
-    @return: Nothing, used to visit nodes along the tree.
+    @param[in]: The number of nodes the descent visited.
+    @return: Nothing. The descent counters are updated.
     */
-    void privateInOrder(BinaryTreeNode* node, void (*visit)(const DATA_TYPE& item))
+    void recordDescent(int depth) const
     {
-        if (!node)
-            return;
+        descents.add(1);
+        descentNodes.add(depth);
+        descentDepths[min(depth, TreeStats::DEPTH_BUCKETS - 1)].add(1);
+    }
+#endif
+    /*
+    Create node function allocates a node from the node allocator and constructs its value in place from the arguments, copying or moving an item as given.
+
+    @param[in]: The arguments for the constructor of the stored value.
+    @return: A new unlinked node of height 1.
+    */
+    template <typename... ARGS>
+    BinaryTreeNode* createNode(ARGS&&... args)
+    {
+        BinaryTreeNode* node = NodeAllocatorTraits::allocate(nodeAllocator, 1);
+        try
+        {
+            NodeAllocatorTraits::construct(nodeAllocator, node, std::forward<ARGS>(args)...);
+        }
+        catch (...)
+        {
+            NodeAllocatorTraits::deallocate(nodeAllocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+    /*
+    Destroy node function destroys the value held by a node and returns its memory to the node allocator.
+
+    @param[in]: The node being destroyed.
+    @return: Nothing. The node is no longer usable.
+    */
+    void destroyNode(BinaryTreeNode* node)
+    {
+        NodeAllocatorTraits::destroy(nodeAllocator, node);
+        NodeAllocatorTraits::deallocate(nodeAllocator, node, 1);
+    }
+    template <typename KEY>
+    BinaryTreeNode* findParentOrDuplicate(const KEY& item, int& lastComparison) const;
+    template <typename KEY>
+    BinaryTreeNode* findParentOrDuplicate(const KEY& item) const
+    {
+        int lastComparison;
+        return findParentOrDuplicate(item, lastComparison);
+    }
+    template <typename KEY>
+    BinaryTreeNode* findNode(const KEY& item) const;
+    template <typename KEY>
+    BinaryTreeNode* lowerBoundNode(const KEY& item) const;
+    template <typename KEY>
+    BinaryTreeNode* upperBoundNode(const KEY& item) const;
+    /*
+    Remove node function unlinks a node from the tree, rebalancing on the way up, and deletes it.
+
+    @param[in]: The node to delete out of the tree.
+    @return: The tree without the node, potentially rebalanced based on deletion changes.
+    */
+    void removeNode(BinaryTreeNode* node)
+    {
+        this->unlinkAndRebalance(node);
+        destroyNode(node);
+        nodeCount--;
+    }
+    /*
+    Post order delete function systematically deletes all nodes below and including the node inputted into the function. Used for destructor of tree and clear.
+    The walk is iterative: it goes down to a leaf, detaches and deletes it, and climbs back up through the parent pointer, so it uses no recursion or stack
+    however deep the subtree is.
+
+    When the node memory will be released in bulk afterwards, only the values are destroyed and the nodes are not handed back one at a time.
+
+    @param[in]: Node to be deleted, along with all children, and whether the node memory is also freed.
+    @return: The deletion of said nodes, usually destroying the tree.
+    */
+    void postOrderDelete(BinaryTreeNode* node, bool freeNodes = true)
+    {
+        if (!node)
+            return;
+
+        BinaryTreeNode* stop = node->parent;
+        while (node != stop)
+        {
+            if (node->leftChild)
+            {
+                node = node->leftChild;
+            }
+            else if (node->rightChild)
+            {
+                node = node->rightChild;
+            }
+            else
+            {
+                BinaryTreeNode* parent = node->parent;
+                if (parent != stop)
+                {
+                    if (parent->leftChild == node)
+                        parent->leftChild = nullptr;
+                    else
+                        parent->rightChild = nullptr;
+                }
+                if (freeNodes)
+                    destroyNode(node);
+                else
+                    NodeAllocatorTraits::destroy(nodeAllocator, node);
+                node = parent;
+            }
+        }
+    }
+
+    template <typename ITERATOR>
+    BinaryTreeNode* buildBalanced(ITERATOR& next, size_t count);
+    /*
+    Attach node function links a new node below the parent found by the descent, or as the root of an empty tree, rebalancing on the way up, and counts it.
+
+    @param[in]: The parent found by findParentOrDuplicate, null for an empty tree, the new unlinked node, and the last comparison result of the descent.
+    @return: The tree with the new node, potentially rebalanced.
+    */
+    void attachNode(BinaryTreeNode* parentNode, BinaryTreeNode* node, int lastComparison)
+    {
+        nodeCount++;
+        this->linkAndRebalance(parentNode, node, lastComparison);
+    }
+    int countLess(const DATA_TYPE& item, bool inclusive) const;
+
+    //Set operations fork their two recursive halves onto separate threads only while both trees are at least this tall, a few thousand nodes or more.
+    static const int PARALLEL_HEIGHT = 16;
+    enum class SetOperation { UNION, INTERSECTION, DIFFERENCE };
+    /*
+    Link node function makes a node the root of two detached subtrees, setting its height and size, and leaves it detached with no parent. With subtreeHeight it
+    lets the join functions build subtrees without a tree around them.
+
+    @param[in]: The left subtree, the node, and the right subtree.
+    @return: The node as the root of the new subtree.
+    */
+    static BinaryTreeNode* linkNode(BinaryTreeNode* left, BinaryTreeNode* node, BinaryTreeNode* right)
+    {
+        node->leftChild = left;
+        node->rightChild = right;
+        node->parent = nullptr;
+        if (left)
+            left->parent = node;
+        if (right)
+            right->parent = node;
+        node->treeHeight = 1 + max(subtreeHeight(left), subtreeHeight(right));
+        updateSize(node);
+        return node;
+    }
+    /*
+    Subtree rotation functions rotate the root of a detached subtree, rebuilding the two nodes involved with linkNode rather than fixing up a parent in the tree.
+
+    @param[in]: The root of the subtree, whose child on the other side must not be null.
+    @return: The new root of the subtree.
+    */
+    static BinaryTreeNode* rotateSubtreeLeft(BinaryTreeNode* node)
+    {
+        BinaryTreeNode* right = node->rightChild;
+        BinaryTreeNode* rightRight = right->rightChild;
+        return linkNode(linkNode(node->leftChild, node, right->leftChild), right, rightRight);
+    }
+    static BinaryTreeNode* rotateSubtreeRight(BinaryTreeNode* node)
+    {
+        BinaryTreeNode* left = node->leftChild;
+        BinaryTreeNode* leftLeft = left->leftChild;
+        return linkNode(leftLeft, left, linkNode(left->rightChild, node, node->rightChild));
+    }
+    /*
+    Detach function cuts a subtree loose from its parent, and count nodes function counts a detached subtree by walking it in order.
+
+    @param[in]: The root of the subtree, possibly null.
+    @return: The subtree root, or the number of nodes in the subtree.
+    */
+    static BinaryTreeNode* detach(BinaryTreeNode* node)
+    {
+        if (node)
+            node->parent = nullptr;
+        return node;
+    }
+    static int countNodes(BinaryTreeNode* node)
+    {
+        int counted = 0;
+        for (node = node ? leftmostNode(node) : nullptr; node; node = successorNode(node))
+            counted++;
+        return counted;
+    }
+    static BinaryTreeNode* joinRight(BinaryTreeNode* left, BinaryTreeNode* node, BinaryTreeNode* right);
+    static BinaryTreeNode* joinLeft(BinaryTreeNode* left, BinaryTreeNode* node, BinaryTreeNode* right);
+    static BinaryTreeNode* joinNodes(BinaryTreeNode* left, BinaryTreeNode* node, BinaryTreeNode* right);
+    static BinaryTreeNode* joinTwo(BinaryTreeNode* left, BinaryTreeNode* right);
+    static BinaryTreeNode* splitLast(BinaryTreeNode* node, BinaryTreeNode*& last);
+    BinaryTreeNode* splitNodes(BinaryTreeNode* node, const DATA_TYPE& key, BinaryTreeNode*& less, BinaryTreeNode*& greater) const;
+    template <SetOperation OPERATION>
+    BinaryTreeNode* combineNodes(BinaryTreeNode* first, BinaryTreeNode* second, vector<BinaryTreeNode*>& discarded, int forkDepth) const;
+    template <SetOperation OPERATION>
+    void combineWith(BinarySearchTree& other);
+    template <SetOperation OPERATION>
+    void combineRoot(BinaryTreeNode* otherRoot, int otherCount, int forkDepth, vector<DATA_TYPE>* rejected);
+    BinaryTreeNode* takeNodes(BinarySearchTree& other);
+    template <typename ITERATOR>
+    BinaryTreeNode* removeSorted(BinaryTreeNode* node, ITERATOR first, size_t count, vector<BinaryTreeNode*>& discarded, vector<DATA_TYPE>* notFound, int forkDepth) const;
+    template <typename ITERATOR>
+    size_t sortedLength(ITERATOR first, ITERATOR last, bool& repeated) const;
+    void writeImage(ostream& image) const;
+    /*
+    Fork depth function gives the number of times a set or batch operation may fork, enough for one thread per hardware thread, or none when it should run on
+    the calling thread alone.
+
+    @param[in]: Whether the operation may run in parallel.
+    @return: The number of forks allowed along any path of the recursion.
+    */
+    static int forkDepthFor(bool parallel)
+    {
+        int forkDepth = 0;
+        while (parallel && (1u << forkDepth) < thread::hardware_concurrency())
+            forkDepth++;
+        return forkDepth;
+    }
+    /*
+    Fork task function starts a task on another thread for a fork of a set or batch operation. When no thread can be started, it returns an empty future rather
+    than throwing, and the caller runs the task itself.
+
+    @param[in]: The task to run, which must own copies of anything it shares with the caller.
+    @return: The future of the task, or an empty future if it was not started.
+    */
+    template <typename TASK>
+    static future<BinaryTreeNode*> forkTask(TASK task)
+    {
+        try
+        {
+            return async(launch::async, std::move(task));
+        }
+        catch (const system_error&)
+        {
+            return future<BinaryTreeNode*>();
+        }
+    }
+
+public:
+    /*
+    Iterator class is a bidirectional iterator over the values of the tree in order. It walks the parent pointers of the nodes, so it needs no stack, and keeps a
+    pointer to its tree so the end iterator can be decremented to the largest value. Values are read only, since changing one could break the binary search property.
+
+    @param[in]: The tree being traversed and the node the iterator is positioned at, null for the end position.
+    @return: An iterator usable with range-for loops and the standard algorithms.
+    */
+    class Iterator
+    {
+        const BinarySearchTree* tree;
+        BinaryTreeNode* node;
+
+        friend class BinarySearchTree;
+        Iterator(const BinarySearchTree* owner, BinaryTreeNode* position) : tree(owner), node(position) {}
+
+    public:
+        using iterator_category = bidirectional_iterator_tag;
+        using value_type = DATA_TYPE;
+        using difference_type = ptrdiff_t;
+        using pointer = const DATA_TYPE*;
+        using reference = const DATA_TYPE&;
+
+        Iterator() : tree(nullptr), node(nullptr) {}
+
+        reference operator*() const
+        {
+            return node->nodeValue;
+        }
+        pointer operator->() const
+        {
+            return &node->nodeValue;
+        }
+        Iterator& operator++()
+        {
+            node = successorNode(node);
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+        Iterator& operator--()
+        {
+            node = node ? predecessorNode(node) : rightmostNode(tree->root);
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator previous = *this;
+            --(*this);
+            return previous;
+        }
+        bool operator==(const Iterator& other) const
+        {
+            return node == other.node;
+        }
+        bool operator!=(const Iterator& other) const
+        {
+            return node != other.node;
+        }
+    };
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+    using reverse_iterator = std::reverse_iterator<Iterator>;
+    using const_reverse_iterator = std::reverse_iterator<Iterator>;
+
+    //Public function declarations, and definitions for simple functions.
+    BinarySearchTree(Compare cmp = defaultCompare<Compare>(), const Allocator& alloc = Allocator());
+    template <typename ITERATOR>
+    BinarySearchTree(ITERATOR first, ITERATOR last, bool sortAndDeduplicate = false, Compare cmp = defaultCompare<Compare>(), const Allocator& alloc = Allocator());
+    ~BinarySearchTree();
+    void clear();
+    void validate() const;
+
+    template <typename ITERATOR>
+    void assignSorted(ITERATOR first, ITERATOR last, bool sortAndDeduplicate = false);
+
+    void insert(const DATA_TYPE& item);
+    void insert(DATA_TYPE&& item);
+    void remove(const DATA_TYPE& item);
+    const DATA_TYPE& search(const DATA_TYPE& item) const;
+    void searchBatch(const vector<DATA_TYPE>& keys, vector<const DATA_TYPE*>& results) const;
+    pair<Iterator, bool> tryInsert(const DATA_TYPE& item);
+    pair<Iterator, bool> tryInsert(DATA_TYPE&& item);
+    template <typename... ARGS>
+    pair<Iterator, bool> emplace(ARGS&&... args);
+    using Links::insertRebalance;
+    using Links::removeRebalance;
+    /*
+    Count function simply returns nodeCount to display number of nodes in a tree.
+
+    @param[in]: Nothing.
+    @return: The current number of nodes in a tree.
+*/
+    int count() const
+    {
+        return nodeCount;
+    }
+#ifdef AVL_TREE_STATS
+    /*
+    Nodes touched functions read and reset the number of nodes visited by descents, height update walks, and rotations since the last reset. They only exist when
+    AVL_TREE_STATS is defined before including this file.
+
+    @param[in]: Nothing.
+    @return: The number of nodes touched.
+    */
+    long long nodesTouched() const
+    {
+        return touchedNodes.get();
+    }
+    void resetNodesTouched()
+    {
+        touchedNodes.reset();
+    }
+    /*
+    Stats functions take a snapshot of every instrumentation counter, for export to a metrics system, and reset them all. They only exist when AVL_TREE_STATS is
+    defined before including this file.
+
+    @param[in]: Nothing.
+    @return: The counts since the last reset.
+    */
+    TreeStats stats() const
+    {
+        TreeStats snapshot;
+        snapshot.comparisons = compare.calls.get();
+        snapshot.leftRotations = leftRotations.get();
+        snapshot.rightRotations = rightRotations.get();
+        snapshot.insertRebalances = insertRebalances.get();
+        snapshot.removeRebalances = removeRebalances.get();
+        snapshot.descents = descents.get();
+        snapshot.descentNodes = descentNodes.get();
+        snapshot.nodesTouched = touchedNodes.get();
+        for (int depth = 0; depth < TreeStats::DEPTH_BUCKETS; depth++)
+            snapshot.descentDepths[depth] = descentDepths[depth].get();
+        return snapshot;
+    }
+    void resetStats()
+    {
+        for (TreeStatCounter* counter : { &compare.calls, &leftRotations, &rightRotations, &insertRebalances, &removeRebalances, &descents, &descentNodes, &touchedNodes })
+            counter->reset();
+        for (TreeStatCounter& counter : descentDepths)
+            counter.reset();
+    }
+#endif
+    /*
+    Find function scans through tree for an item without throwing when it is missing, for callers where a miss is a normal outcome. Try remove function deletes
+    the item if it exists, again without throwing if it does not. Lower bound and upper bound functions find the first value not less than, or greater than, the
+    item.
+
+    Each also has an overload taking a key of another type, available only when the compare policy declares is_transparent, such as ThreeWayCompare<>. An
+    ordinary policy therefore never converts such a key into a temporary DATA_TYPE on every comparison.
+
+    @param[in]: An item, or a key the compare policy can compare against stored values.
+    @return: A pointer to the value or null, whether anything was removed, or an iterator at the bound or end.
+    */
+    const DATA_TYPE* find(const DATA_TYPE& item) const
+    {
+        BinaryTreeNode* node = findNode(item);
+        return node ? &node->nodeValue : nullptr;
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    const DATA_TYPE* find(const KEY& key) const
+    {
+        BinaryTreeNode* node = findNode(key);
+        return node ? &node->nodeValue : nullptr;
+    }
+    bool tryRemove(const DATA_TYPE& item)
+    {
+        BinaryTreeNode* node = findNode(item);
+        if (node)
+            removeNode(node);
+        return node != nullptr;
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    bool tryRemove(const KEY& key)
+    {
+        BinaryTreeNode* node = findNode(key);
+        if (node)
+            removeNode(node);
+        return node != nullptr;
+    }
+    Iterator lowerBound(const DATA_TYPE& item) const
+    {
+        return Iterator(this, lowerBoundNode(item));
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    Iterator lowerBound(const KEY& key) const
+    {
+        return Iterator(this, lowerBoundNode(key));
+    }
+    Iterator upperBound(const DATA_TYPE& item) const
+    {
+        return Iterator(this, upperBoundNode(item));
+    }
+    template <typename KEY, typename C = Compare, typename = typename C::is_transparent>
+    Iterator upperBound(const KEY& key) const
+    {
+        return Iterator(this, upperBoundNode(key));
+    }
+    template <typename KEY, typename... ARGS>
+    pair<Iterator, bool> tryEmplace(const KEY& key, ARGS&&... args);
+    pair<Iterator, Iterator> equalRange(const DATA_TYPE& item) const;
+    template <typename VISIT>
+    void forEachInRange(const DATA_TYPE& low, const DATA_TYPE& high, VISIT visit) const;
+    const DATA_TYPE& select(int k) const;
+    int rank(const DATA_TYPE& item) const;
+    int countRange(const DATA_TYPE& low, const DATA_TYPE& high) const;
+    FrozenSearchTree<DATA_TYPE, Compare> freeze() const;
+    void save(const string& path) const;
+    void load(const string& path);
+    void join(BinarySearchTree& other);
+    void split(const DATA_TYPE& key, BinarySearchTree& upper);
+    void unionWith(BinarySearchTree& other);
+    void intersectWith(BinarySearchTree& other);
+    void differenceWith(BinarySearchTree& other);
+    template <typename ITERATOR>
+    int insertBatch(ITERATOR first, ITERATOR last, vector<DATA_TYPE>* duplicates = nullptr, bool parallel = false);
+    template <typename ITERATOR>
+    int removeBatch(ITERATOR first, ITERATOR last, vector<DATA_TYPE>* notFound = nullptr, bool parallel = false);
+    /*
+    In order function calls the visit function on every value in ascending order, walking the tree with iterators rather than recursion. The visit function may be
+    a function pointer, a functor, or a lambda carrying its own state.
+
+    @param[in]: The function to call on each value.
+    @return: Nothing. Visits every value of the tree.
+    */
+    template <typename VISIT>
+    void inOrder(VISIT visit) const
+    {
+        for (const DATA_TYPE& item : *this)
+            visit(item);
+    }
+    /*
+    Begin and end functions return iterators to the smallest value and one past the largest value, and rbegin and rend do the same for the reverse order.
+
+    @param[in]: Nothing.
+    @return: An iterator at the requested position.
+    */
+    Iterator begin() const
+    {
+        return Iterator(this, root ? leftmostNode(root) : nullptr);
+    }
+    Iterator end() const
+    {
+        return Iterator(this, nullptr);
+    }
+    reverse_iterator rbegin() const
+    {
+        return reverse_iterator(end());
+    }
+    reverse_iterator rend() const
+    {
+        return reverse_iterator(begin());
+    }
+
+    /*
+    Public rotation functions are simply accessors to the private rotation functions. These functions find the node that is meant to be rotated, and call on their
+    private counterparts to carry out the operation.
+
+    @param[in]: The value of the node being rotated.
+    @return: A rotated node in the tree.
+    */
+    void rightRotatePublic(DATA_TYPE item)
+    {
+        BinaryTreeNode* rotatedNode = findParentOrDuplicate(item);
+        rotateRight(rotatedNode);
+    }
+    void leftRotatePublic(DATA_TYPE item)
+    {
+        BinaryTreeNode* rotatedNode = findParentOrDuplicate(item);
+        rotateLeft(rotatedNode);
+    }
+    /*
+    Return height function is used in test cases to check the heights of key nodes to ensure operations have been done correctly. Function finds node and then returns
+    the height of the node.
+
+    @param[in]: Value of the node being searched for for its height.
+    @return: The height of the node searched for.
+    */
+    int returnHeight(DATA_TYPE item)
+    {
+        BinaryTreeNode* node = findParentOrDuplicate(item);
+        return node->treeHeight;
+    }
+
+private:
+    //Declared after Iterator, which it returns.
+    template <typename ITEM>
+    pair<Iterator, bool> insertUnique(ITEM&& item);
+};
+/*
+Order statistic tree alias names a BinarySearchTree with subtree sizes enabled, for callers that need select, rank, and countRange.
+*/
+template <typename DATA_TYPE, typename Compare = ThreeWayCompare<DATA_TYPE>, typename Allocator = allocator<DATA_TYPE>>
+using OrderStatisticTree = BinarySearchTree<DATA_TYPE, Compare, Allocator, true>;
+/*
+Constructor for the tree object takes in an instance of the compare policy, and uses it to facilitate the binary search property. Also sets the 
+initial conditions for an empty search tree.
+
+@param[in]: Compare policy instance, defaulted for functor types and required when Compare is CompareFunction, and the allocator to rebind for nodes.
+@return: An empty binary search tree.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinarySearchTree(Compare cmp, const Allocator& alloc) : compare(cmp), nodeAllocator(alloc)
+{
+    nodeCount = 0;
+    root = nullptr;
+}
+/*
+Range constructor builds the tree directly from a range of items using assignSorted, rather than inserting the items one at a time.
+
+@param[in]: The range of items, whether the range must first be sorted and deduplicated, the compare policy instance, and the allocator.
+@return: A perfectly balanced binary search tree holding the items of the range.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename ITERATOR>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinarySearchTree(ITERATOR first, ITERATOR last, bool sortAndDeduplicate, Compare cmp, const Allocator& alloc)
+    : compare(cmp), nodeAllocator(alloc)
+{
+    nodeCount = 0;
+    root = nullptr;
+    assignSorted(first, last, sortAndDeduplicate);
+}
+/*
+Destructor runs clear to fully empty a binary search tree.
+
+@param[in]: Nothing.
+@return: A newly empty tree.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::~BinarySearchTree()
+{
+    clear();
+}
+/*
+Clear function removes every node of the tree, leaving an empty tree that can be reused. It runs postOrderDelete starting at the root, unless the node
+allocator can release its memory in bulk and no other allocator shares it. In that case the blocks are released at once instead, and the node walk is skipped
+entirely for trivially destructible values.
+
+@param[in]: Nothing.
+@return: An empty tree.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::clear()
+{
+    bool released = false;
+    if constexpr (HasBulkRelease<NodeAllocator>::value)
+    {
+        if (nodeAllocator.unshared())
+        {
+            if (!is_trivially_destructible<DATA_TYPE>::value)
+                postOrderDelete(root, false);
+            nodeAllocator.release();
+            released = true;
+        }
+    }
+    if (!released)
+        postOrderDelete(root);
+
+    root = nullptr;
+    nodeCount = 0;
+}
+/*
+Validate function checks every invariant of the tree with validateLinks, ordering the values of the nodes with the compare policy.
+
+@param[in]: Nothing.
+@return: Nothing, or an exception naming the first broken invariant found.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::validate() const
+{
+    this->validateLinks(nodeCount, [this](BinaryTreeNode* previous, BinaryTreeNode* current) { return compare(previous->nodeValue, current->nodeValue) < 0; });
+}
+/*
+Validate links function checks every invariant of the tree in O(n), for tests and for checking a tree after changes to the rebalancing code. Walking the tree
+in order, it checks that:
+  - Each child links back to its parent, and the root has no parent.
+  - Each stored height is one more than the taller of its children's, and the children differ in height by at most one.
+  - Each subtree size, when order statistics are enabled, is one more than the sizes of its children.
+  - The values are in strictly ascending order, which is the binary search property.
+  - The nodes reached number exactly nodeCount.
+The walk keeps its own stack rather than following parent links, and stops as soon as it reaches more nodes than nodeCount, so a damaged tree cannot send it
+round a cycle.
+
+@param[in]: The number of nodes the tree counts, and a function telling whether the value of one node is strictly less than the value of another.
+@return: Nothing, or an exception naming the first broken invariant found.
+*/
+template <typename TREE, typename NODE, bool ORDER_STATISTICS>
+template <typename ORDERED>
+void AVLTreeLinks<TREE, NODE, ORDER_STATISTICS>::validateLinks(int nodeCount, ORDERED ordered) const
+{
+    NODE* root = tree().root;
+    if (root && root->parent)
+        throw InvalidTreeException(__LINE__, "Root has a parent");
+    vector<NODE*> pending;
+    NODE* previous = nullptr;
+    int reached = 0;
+    NODE* current = root;
+    while (current || !pending.empty())
+    {
+        for (; current; current = current->leftChild)
+        {
+            if (++reached > nodeCount)
+                throw InvalidTreeException(__LINE__, "Tree holds more nodes than nodeCount, or a cycle");
+            NODE* left = current->leftChild;
+            NODE* right = current->rightChild;
+            if ((left && left->parent != current) || (right && right->parent != current))
+                throw InvalidTreeException(__LINE__, "Child does not link back to its parent");
+            if (current->treeHeight != 1 + max(subtreeHeight(left), subtreeHeight(right)))
+                throw InvalidTreeException(__LINE__, "Stored height does not match the heights of the children");
+            if (abs(subtreeHeight(left) - subtreeHeight(right)) > 1)
+                throw InvalidTreeException(__LINE__, "Children differ in height by more than one");
+            if constexpr (ORDER_STATISTICS)
+            {
+                if (current->subtreeSize != 1 + subtreeSize(left) + subtreeSize(right))
+                    throw InvalidTreeException(__LINE__, "Stored subtree size does not match the sizes of the children");
+            }
+            pending.push_back(current);
+        }
+        current = pending.back();
+        pending.pop_back();
+        if (previous && !ordered(previous, current))
+            throw InvalidTreeException(__LINE__, "Values are not in strictly ascending order");
+        previous = current;
+        current = current->rightChild;
+    }
+    if (reached != nodeCount)
+        throw InvalidTreeException(__LINE__, "Tree holds fewer nodes than nodeCount");
+}
+/*
+Assign sorted function replaces the contents of the tree with the items of a range in linear time. The middle item of each subrange becomes the root of its subtree,
+so the result is perfectly balanced with heights and parents set as it is built, and no searching or rebalancing is done. The range must be in strictly ascending
+order, which is checked before the old contents are dropped, unless sortAndDeduplicate is set, in which case the items are first copied, sorted, and stripped
+of duplicates.
+
+@param[in]: A range of forward iterators over the items, and whether the range must first be sorted and deduplicated.
+@return: The tree holding exactly the items of the range. An unsorted or duplicated range throws and leaves the tree unchanged.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename ITERATOR>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::assignSorted(ITERATOR first, ITERATOR last, bool sortAndDeduplicate)
+{
+    if (sortAndDeduplicate)
+    {
+        vector<DATA_TYPE> items(first, last);
+        sort(items.begin(), items.end(), [this](const DATA_TYPE& item1, const DATA_TYPE& item2) { return compare(item1, item2) < 0; });
+        items.erase(unique(items.begin(), items.end(), [this](const DATA_TYPE& item1, const DATA_TYPE& item2) { return compare(item1, item2) == 0; }), items.end());
+        assignSorted(make_move_iterator(items.begin()), make_move_iterator(items.end()));
+        return;
+    }
+
+    size_t itemCount = 0;
+    if (first != last)
+    {
+        itemCount = 1;
+        ITERATOR previous = first;
+        for (ITERATOR current = std::next(first); current != last; ++current, ++previous, itemCount++)
+        {
+            int result = compare(*previous, *current);
+            if (result == 0)
+                throw DuplicateItemException(__LINE__, "Duplicate item detected. Unable to bulk load");
+            if (result > 0)
+                throw UnsortedInputException(__LINE__, "Items are not in ascending order. Unable to bulk load");
+        }
+    }
+
+    BinaryTreeNode* newRoot = buildBalanced(first, itemCount);
+    postOrderDelete(root);
+    root = newRoot;
+    nodeCount = (int)itemCount;
+}
+/*
+Build balanced function recursively creates a balanced subtree from the next count items of a sorted range, building the left half, then the middle node, then
+the right half, so the iterator is only ever moved forwards. If creating a node throws, the nodes built so far are freed before the exception continues.
+
+@param[in]: The iterator at the next unused item, advanced as nodes are created, and the number of items in the subtree.
+@return: The root of the new subtree, or null for an empty subtree.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename ITERATOR>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode* BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::buildBalanced(ITERATOR& next, size_t count)
+{
+    if (count == 0)
+        return nullptr;
+
+    size_t leftCount = count / 2;
+    BinaryTreeNode* left = buildBalanced(next, leftCount);
+    BinaryTreeNode* node = nullptr;
+    try
+    {
+        node = createNode(*next);
+    }
+    catch (...)
+    {
+        postOrderDelete(left);
+        throw;
+    }
+    ++next;
+
+    node->leftChild = left;
+    if (left)
+        left->parent = node;
+    try
+    {
+        node->rightChild = buildBalanced(next, count - leftCount - 1);
+    }
+    catch (...)
+    {
+        postOrderDelete(node);
+        throw;
+    }
+    if (node->rightChild)
+        node->rightChild->parent = node;
+
+    node->treeHeight = getHeight(node);
+    updateSize(node);
+    return node;
+}
+
+/*
+Insert functions take in a value and add it to the tree using tryInsert, copying or moving the value into the new node. Exception is thrown if the inserted item
+already exists.
+
+@param[in]: An item to store in a new node.
+@return: The tree with the new node, potentially rebalanced.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::insert(const DATA_TYPE& item)
+{
+    if (!tryInsert(item).second)
+    {
+        // Duplicate item detected, throw an exception
+        DuplicateItemException exception(__LINE__, "Duplicate item detected. Unable to insert");
+        throw exception;
+    }
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::insert(DATA_TYPE&& item)
+{
+    if (!tryInsert(std::move(item)).second)
+    {
+        // Duplicate item detected, throw an exception
+        DuplicateItemException exception(__LINE__, "Duplicate item detected. Unable to insert");
+        throw exception;
+    }
+}
+/*
+Try insert functions take in a value and insert it into the tree where it fits best based on the binary search property, or at the root if the tree is empty, copying
+or moving the value into the new node. Nothing is inserted if the item already exists, and no exception is thrown.
+
+@param[in]: An item to store in a new node.
+@return: An iterator at the item in the tree, and whether it was newly inserted rather than already present.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+pair<typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::Iterator, bool>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::tryInsert(const DATA_TYPE& item)
+{
+    return insertUnique(item);
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+pair<typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::Iterator, bool>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::tryInsert(DATA_TYPE&& item)
+{
+    return insertUnique(std::move(item));
+}
+/*
+Emplace function constructs a value directly inside a new node from the arguments, then inserts the node if no equal value exists. Since the value must exist before it
+can be compared, a duplicate is constructed and then destroyed again.
+
+@param[in]: The arguments for the constructor of the value.
+@return: An iterator at the equal value in the tree, and whether the new value was inserted.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename... ARGS>
+pair<typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::Iterator, bool>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::emplace(ARGS&&... args)
+{
+    BinaryTreeNode* node = createNode(std::forward<ARGS>(args)...);
+    int lastComparison;
+    BinaryTreeNode* searchNode = findParentOrDuplicate(node->nodeValue, lastComparison);
+    if (searchNode && !lastComparison)
+    {
+        destroyNode(node);
+        return make_pair(Iterator(this, searchNode), false);
+    }
+
+    attachNode(searchNode, node, lastComparison);
+    return make_pair(Iterator(this, node), true);
+}
+/*
+Try emplace function looks up a key first and only constructs a new value from the arguments when the key is missing, so a hit costs one descent and no
+construction. The key must compare against stored values the same way the constructed value will, as the key of a map entry does.
+
+@param[in]: The key to look for, and the arguments for the constructor of the value.
+@return: An iterator at the value with the key, and whether a new value was inserted.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename KEY, typename... ARGS>
+pair<typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::Iterator, bool>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::tryEmplace(const KEY& key, ARGS&&... args)
+{
+    int lastComparison;
+    BinaryTreeNode* searchNode = findParentOrDuplicate(key, lastComparison);
+    if (searchNode && !lastComparison)
+        return make_pair(Iterator(this, searchNode), false);
+
+    BinaryTreeNode* node = createNode(std::forward<ARGS>(args)...);
+    attachNode(searchNode, node, lastComparison);
+    return make_pair(Iterator(this, node), true);
+}
+/*
+Insert unique function finds the parent node for an item, or identifies a duplicate entry, and only then creates the node, forwarding the item so an rvalue is moved
+into it rather than copied.
+
+@param[in]: An item to store in a new node, as an lvalue or rvalue.
+@return: An iterator at the item in the tree, and whether it was newly inserted rather than already present.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename ITEM>
+pair<typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::Iterator, bool>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::insertUnique(ITEM&& item)
+{
+    // Find the parent node, or identify a duplicate entry
+    int lastComparison;
+    BinaryTreeNode* searchNode = findParentOrDuplicate(item, lastComparison);
+    if (searchNode && !lastComparison) // Check to see if the item already exists
+        return make_pair(Iterator(this, searchNode), false);
+
+    // Create new node
+    BinaryTreeNode* node = createNode(std::forward<ITEM>(item));
+    attachNode(searchNode, node, lastComparison);
+    return make_pair(Iterator(this, node), true);
+}
+/*
+Link and rebalance function links a new node below the parent found for it, or at the root if the tree is empty. After attaching, a loop travels back up the tree from the
+point of insertion, and updates the heights until it reaches the root, finds a case where rebalancing using a function call is necessary, or finds a node whose
+height did not change, since no height above it can change either.
+
+@param[in]: The parent found by findParentOrDuplicate, null for an empty tree, the new unlinked node, and the last comparison result of the descent.
+@return: The tree with the new node, potentially rebalanced.
+*/
+template <typename TREE, typename NODE, bool ORDER_STATISTICS>
+void AVLTreeLinks<TREE, NODE, ORDER_STATISTICS>::linkAndRebalance(NODE* searchNode, NODE* node, int lastComparison)
+{
+    //Empty tree case
+    if (!searchNode)
+    {
+        tree().root = node;
+        return;
+    }
+
+    // Link the parent
+    node->parent = searchNode;
+
+    // The last comparison of the descent determines if the node will be a left or right child
+    // Attach the node to the appropriate side
+    if (lastComparison > 0)
+        searchNode->leftChild = node;
+    else
+        searchNode->rightChild = node;
+
+    //Sizes are counted before any rotation, since rotations keep the total of the subtree they act on.
+    adjustSizes(searchNode, 1);
+
+    //Rebalance checks
+    NODE* previousNode = nullptr;
+    NODE* prePreviousNode = nullptr;
+    int balanceFactor = 0;
+
+    while (node->parent)
+    {
+        //Traversal up tree
+        prePreviousNode = previousNode;
+        previousNode = node;
+        node = node->parent;
+        AVL_TOUCH_NODES(1);
+
+        //Calculation of balance factor
+        int rightTreeHeight = 0;
+        int leftTreeHeight = 0;
+        NODE* right = node->rightChild;
+        NODE* left = node->leftChild;
+        if (right != nullptr)
+        {
+            rightTreeHeight = right->treeHeight;
+        }
+        if (left != nullptr)
+        {
+            leftTreeHeight = left->treeHeight;
+        }
+        balanceFactor = rightTreeHeight - leftTreeHeight;
+        //Check of balance factor in case of rebalancing.
+        if (balanceFactor < -1 || balanceFactor > 1)
+        {
+            insertRebalance(node, previousNode, prePreviousNode);
+            break;
+        }
+        //Update height if no rebalance needed, stopping once a height stays the same.
+        int newHeight = getHeight(node);
+        if (newHeight == node->treeHeight)
+            break;
+        node->treeHeight = newHeight;
+    }
+}
+/*
+Delete function takes in a value, and deletes the node holding that value using tryRemove. If the value is not in the tree, an item not found exception will be thrown.
+
+@param[in]: An item to delete out of the tree.
+@return: The tree without the node, potentially rebalanced based on deletion changes.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::remove(const DATA_TYPE& item)
+{
+    if (!tryRemove(item))
+    {
+        // Throw item not found exception
+        throw ItemNotFoundException(__LINE__, "Item was not found");
+    }
+}
+/*
+Unlink and rebalance function unlinks a node from the tree without deleting it. Function checks for simple or complex deletion case, and handles it accordingly. Afterwards, delete
+loops back up the tree starting from the parent of the unlinked node, rebalancing the tree in any cases where the balance factor of a node is off, until it reaches
+the root or a subtree whose height ended up unchanged.
+
+@param[in]: The node to unlink from the tree.
+@return: The tree without the node, potentially rebalanced based on deletion changes. The node's own links are left as they were.
+*/
+template <typename TREE, typename NODE, bool ORDER_STATISTICS>
+void AVLTreeLinks<TREE, NODE, ORDER_STATISTICS>::unlinkAndRebalance(NODE* searchResult)
+{
+
+    // Check to see if it is a simple or hard case
+    NODE* parent = nullptr;
+    if (searchResult->leftChild && searchResult->rightChild)
+    {
+        // Find the immediate predecessor
+        NODE* current = rightmostNode(searchResult->leftChild);
+
+        // Unlink the predecessor from its place, where it has no right child. Rebalancing starts from its old parent, or from the predecessor itself if it was the
+        // direct left child, since its left subtree is what shrinks.
+        if (current->parent == searchResult)
+        {
+            parent = current;
+        }
+        else
+        {
+            parent = current->parent;
+            replaceChild(parent, current, current->leftChild);
+            current->leftChild = searchResult->leftChild;
+            current->leftChild->parent = current;
+        }
+
+        // Move the predecessor node into the place of the removed node, rather than copying values between them
+        current->rightChild = searchResult->rightChild;
+        current->rightChild->parent = current;
+        replaceChild(searchResult->parent, searchResult, current);
+        current->treeHeight = searchResult->treeHeight;
+        if constexpr (ORDER_STATISTICS)
+            current->subtreeSize = searchResult->subtreeSize;
+    }
+    else
+    {
+        //Setting the only child, if any, to the proper child pointer of parent, or to the root if no parent exists.
+        NODE* child = searchResult->rightChild ? searchResult->rightChild : searchResult->leftChild;
+        parent = searchResult->parent;
+        replaceChild(parent, searchResult, child);
+    }
+
+    adjustSizes(parent, -1);
+
+    //Rebalance checks
+    int balanceFactor = 0;
+
+    while (parent)
+    {
+        AVL_TOUCH_NODES(1);
+        //Calculate new height, keeping the old one to see whether this subtree changed height
+        int oldHeight = parent->treeHeight;
+        parent->treeHeight = getHeight(parent);
+
+        //Calculate balance factor.
+        int rightTreeHeight = 0;
+        int leftTreeHeight = 0;
+        NODE* right = parent->rightChild;
+        NODE* left = parent->leftChild;
+        if (right != nullptr)
+        {
+            rightTreeHeight = right->treeHeight;
+        }
+        if (left != nullptr)
+        {
+            leftTreeHeight = left->treeHeight;
+        }
+        balanceFactor = rightTreeHeight - leftTreeHeight;
+        //Check for any necessary rebalance.
+        NODE* subtreeRoot = parent;
+        if (balanceFactor < -1 || balanceFactor > 1)
+        {
+            subtreeRoot = removeRebalance(parent);
+        }
+        //Stop once the subtree is as tall as before, since no height above it can change.
+        if (subtreeRoot->treeHeight == oldHeight)
+            break;
+        //Traversal up tree.
+        parent = subtreeRoot->parent;
+    }
+}
+/*
+Search function scans through tree using find and returns searched-for value, or an exception if the item was not found.
+
+@param[in]: An item to search for in tree.
+@return: A reference to the value of the node searched for, valid until that value is removed.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+const DATA_TYPE& BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::search(const DATA_TYPE& item) const
+{
+    const DATA_TYPE* searchResult = find(item);
+    if (!searchResult)
+    {
+        // Throw ItemNotFoundException
+        throw ItemNotFoundException(__LINE__, "Item was not found");
+    }
+
+    return *searchResult;
+}
+/*
+Search batch function looks up many keys at once. Rather than finishing one descent before starting the next, it keeps a group of descents in flight and advances
+each by one level in turn, prefetching the child it moves to, so the cache misses of independent descents overlap instead of stalling one after another. When
+a descent finishes, the next key takes its place in the group. Like find, a missing key is reported with null rather than an exception.
+
+@param[in]: The keys to look up, and the vector to store the results in, which is resized to match the keys.
+@return: For each key, a pointer to the value equal to it, or null if it was not found.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::searchBatch(const vector<DATA_TYPE>& keys, vector<const DATA_TYPE*>& results) const
+{
+    //Number of descents kept in flight, enough to cover memory latency without the group itself spilling out of the first level cache.
+    const size_t GROUP_SIZE = 16;
+    size_t descentKeys[GROUP_SIZE];
+    BinaryTreeNode* descentNodes[GROUP_SIZE];
+    size_t nextKey = 0;
+    size_t active = 0;
+
+    results.assign(keys.size(), nullptr);
+    if (!root)
+        return;
+    for (; active < GROUP_SIZE && nextKey < keys.size(); active++, nextKey++)
+    {
+        descentKeys[active] = nextKey;
+        descentNodes[active] = root;
+    }
+
+    while (active)
+    {
+        for (size_t lane = 0; lane < active;)
+        {
+            BinaryTreeNode* current = descentNodes[lane];
+            AVL_TOUCH_NODES(1);
+            int result = compare(current->nodeValue, keys[descentKeys[lane]]);
+            BinaryTreeNode* next = result > 0 ? current->leftChild : current->rightChild;
+            if (result && next)
+            {
+                AVL_PREFETCH(next);
+                descentNodes[lane++] = next;
+                continue;
+            }
+
+            //This descent is finished. Start the next key in its place, or close the gap with the last descent of the group.
+            if (!result)
+                results[descentKeys[lane]] = &current->nodeValue;
+            if (nextKey < keys.size())
+            {
+                descentKeys[lane] = nextKey++;
+                descentNodes[lane] = root;
+            }
+            else
+            {
+                active--;
+                descentKeys[lane] = descentKeys[active];
+                descentNodes[lane] = descentNodes[active];
+            }
+        }
+    }
+}
+/*
+Find node function scans through tree for an item without throwing when it is missing, for callers where a miss is a normal outcome.
+
+@param[in]: An item to search for in tree, or a key the compare policy can compare against stored values.
+@return: The node holding the item, or null if the item was not found.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename KEY>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode* BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::findNode(const KEY& item) const
+{
+    int lastComparison;
+    BinaryTreeNode* searchResult = findParentOrDuplicate(item, lastComparison);
+    if (!searchResult || lastComparison)
+        return nullptr;
+
+    return searchResult;
+}
+/*
+Lower bound node function finds the first value that is not less than an item. It reuses findParentOrDuplicate: the node it stops at is either the item itself, a
+parent the item would hang to the left of, which is the next larger value, or a parent the item would hang to the right of, whose successor is the answer.
+
+@param[in]: The item to bound, or a key the compare policy can compare against stored values.
+@return: The node of the first value not less than the item, or null if every value is less.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename KEY>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode* BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::lowerBoundNode(const KEY& item) const
+{
+    int lastComparison;
+    BinaryTreeNode* searchResult = findParentOrDuplicate(item, lastComparison);
+    if (searchResult && lastComparison < 0)
+        searchResult = successorNode(searchResult);
+    return searchResult;
+}
+/*
+Upper bound node function finds the first value that is greater than an item, in the same way as lowerBoundNode except that an exact match is also stepped past.
+
+@param[in]: The item to bound, or a key the compare policy can compare against stored values.
+@return: The node of the first value greater than the item, or null if no value is greater.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename KEY>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode* BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::upperBoundNode(const KEY& item) const
+{
+    int lastComparison;
+    BinaryTreeNode* searchResult = findParentOrDuplicate(item, lastComparison);
+    if (searchResult && lastComparison <= 0)
+        searchResult = successorNode(searchResult);
+    return searchResult;
+}
+/*
+Equal range function returns the range of values equal to an item, which holds either the one matching value or nothing, since the tree has no duplicates.
+
+@param[in]: The item to look for.
+@return: A pair of iterators, the lowerBound and upperBound of the item.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+pair<typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::Iterator, typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::Iterator>
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::equalRange(const DATA_TYPE& item) const
+{
+    Iterator first = lowerBound(item);
+    Iterator last = first;
+    if (last != end() && compare(*last, item) == 0)
+        ++last;
+    return make_pair(first, last);
+}
+/*
+For each in range function calls the visit function on every value between low and high, inclusive of both, in ascending order. It finds the start with lowerBound
+and then steps through successors, so it touches O(log n + k) nodes for k values in range.
+
+@param[in]: The low and high ends of the range, and the function to call on each value.
+@return: Nothing. Visits every value in the range.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename VISIT>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::forEachInRange(const DATA_TYPE& low, const DATA_TYPE& high, VISIT visit) const
+{
+    for (Iterator current = lowerBound(low); current != end() && compare(*current, high) <= 0; ++current)
+        visit(*current);
+}
+/*
+Select function finds the k-th smallest value of the tree by comparing k against the left subtree sizes on the way down, taking O(log n) time. Requires order
+statistics to be enabled.
+
+@param[in]: The position k of the value in sorted order, counting from 0.
+@return: The k-th smallest value, or an exception if k is outside the tree.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+const DATA_TYPE& BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::select(int k) const
+{
+    static_assert(ORDER_STATISTICS, "select requires a tree with ORDER_STATISTICS enabled");
+    if (k < 0 || k >= nodeCount)
+        throw ItemNotFoundException(__LINE__, "Position is outside of the tree");
+
+    BinaryTreeNode* current = root;
+    while (true)
+    {
+        int leftSize = subtreeSize(current->leftChild);
+        if (k == leftSize)
+            return current->nodeValue;
+        if (k < leftSize)
+        {
+            current = current->leftChild;
+        }
+        else
+        {
+            k -= leftSize + 1;
+            current = current->rightChild;
+        }
+    }
+}
+/*
+Rank function counts how many values of the tree are smaller than an item, which is also the position select would find the item at. The item does not need to be
+in the tree. Requires order statistics to be enabled.
+
+@param[in]: The item to rank.
+@return: The number of values less than the item.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+int BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::rank(const DATA_TYPE& item) const
+{
+    static_assert(ORDER_STATISTICS, "rank requires a tree with ORDER_STATISTICS enabled");
+    return countLess(item, false);
+}
+/*
+Count range function counts the values lying between low and high, inclusive of both, as the difference of two descents. Requires order statistics to be enabled.
+
+@param[in]: The low and high ends of the range.
+@return: The number of values in the range, or 0 if low is greater than high.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+int BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::countRange(const DATA_TYPE& low, const DATA_TYPE& high) const
+{
+    static_assert(ORDER_STATISTICS, "countRange requires a tree with ORDER_STATISTICS enabled");
+    if (compare(low, high) > 0)
+        return 0;
+    return countLess(high, true) - countLess(low, false);
+}
+/*
+Count less function descends toward an item, adding the left subtree and the node itself each time it moves right, to count the values below the item.
+
+@param[in]: The item to count below, and whether values equal to it are also counted.
+@return: The number of values less than, or less than or equal to, the item.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+int BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::countLess(const DATA_TYPE& item, bool inclusive) const
+{
+    int counted = 0;
+    BinaryTreeNode* current = root;
+    while (current)
+    {
+        int result = compare(current->nodeValue, item);
+        if (result < 0 || (inclusive && result == 0))
+        {
+            counted += subtreeSize(current->leftChild) + 1;
+            current = current->rightChild;
+        }
+        else
+        {
+            current = current->leftChild;
+        }
+    }
+    return counted;
+}
+/*
+Join right function joins a left subtree taller than the right one by more than one around a middle node, following the right spine of the left subtree down to
+a subtree no more than one taller than the right one, hanging the middle node there, and rotating on the way back up wherever the heights end up two apart. This
+is the join of Blelloch, Ferizovic, and Sun, and takes time proportional to the difference in heights. Join left is its mirror image.
+
+@param[in]: The left subtree, the middle node, and the right subtree, with every value of the left below the middle and every value of the right above it.
+@return: The root of the joined, balanced subtree, detached.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::joinRight(BinaryTreeNode* left, BinaryTreeNode* node, BinaryTreeNode* right)
+{
+    BinaryTreeNode* leftleftChild = left->leftChild;
+    BinaryTreeNode* leftrightChild = left->rightChild;
+    if (subtreeHeight(leftrightChild) <= subtreeHeight(right) + 1)
+    {
+        BinaryTreeNode* joined = linkNode(leftrightChild, node, right);
+        if (subtreeHeight(joined) <= subtreeHeight(leftleftChild) + 1)
+            return linkNode(leftleftChild, left, joined);
+        return rotateSubtreeLeft(linkNode(leftleftChild, left, rotateSubtreeRight(joined)));
+    }
+    BinaryTreeNode* joined = joinRight(leftrightChild, node, right);
+    BinaryTreeNode* linked = linkNode(leftleftChild, left, joined);
+    return subtreeHeight(joined) <= subtreeHeight(leftleftChild) + 1 ? linked : rotateSubtreeLeft(linked);
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::joinLeft(BinaryTreeNode* left, BinaryTreeNode* node, BinaryTreeNode* right)
+{
+    BinaryTreeNode* rightrightChild = right->rightChild;
+    BinaryTreeNode* rightleftChild = right->leftChild;
+    if (subtreeHeight(rightleftChild) <= subtreeHeight(left) + 1)
+    {
+        BinaryTreeNode* joined = linkNode(left, node, rightleftChild);
+        if (subtreeHeight(joined) <= subtreeHeight(rightrightChild) + 1)
+            return linkNode(joined, right, rightrightChild);
+        return rotateSubtreeRight(linkNode(rotateSubtreeLeft(joined), right, rightrightChild));
+    }
+    BinaryTreeNode* joined = joinLeft(left, node, rightleftChild);
+    BinaryTreeNode* linked = linkNode(joined, right, rightrightChild);
+    return subtreeHeight(joined) <= subtreeHeight(rightrightChild) + 1 ? linked : rotateSubtreeRight(linked);
+}
+/*
+Join nodes function joins two subtrees around a middle node, picking joinRight or joinLeft when their heights differ by more than one and simply linking them
+otherwise. Join two function joins two subtrees without a middle node, by splitting the largest node off the left subtree to use as one.
+
+@param[in]: The left subtree, the middle node for joinNodes, and the right subtree, either subtree possibly null, with the values of the left all lower.
+@return: The root of the joined, balanced subtree, detached, or null if both were empty.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::joinNodes(BinaryTreeNode* left, BinaryTreeNode* node, BinaryTreeNode* right)
+{
+    if (subtreeHeight(left) > subtreeHeight(right) + 1)
+        return joinRight(left, node, right);
+    if (subtreeHeight(right) > subtreeHeight(left) + 1)
+        return joinLeft(left, node, right);
+    return linkNode(left, node, right);
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::joinTwo(BinaryTreeNode* left, BinaryTreeNode* right)
+{
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+    BinaryTreeNode* last = nullptr;
+    BinaryTreeNode* rest = splitLast(left, last);
+    return joinNodes(rest, last, right);
+}
+/*
+Split last function removes the largest node from a detached subtree, rejoining the nodes on its right spine as it returns.
 
-        privateInOrder(node->leftChild, visit);
-        visit(node->data);
-        privateInOrder(node->rightChild, visit);
+@param[in]: The root of the subtree, which must not be null, and where to report the node removed.
+@return: The root of the remaining subtree, detached, or null if it is empty.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::splitLast(BinaryTreeNode* node, BinaryTreeNode*& last)
+{
+    if (!node->rightChild)
+    {
+        last = node;
+        BinaryTreeNode* rest = detach(node->leftChild);
+        node->leftChild = nullptr;
+        return rest;
     }
-    /*
-    Post order delete function systematically deletes all nodes below and including the node inputted into the function. Used for destructor of tree.
+    BinaryTreeNode* rest = splitLast(node->rightChild, last);
+    return joinNodes(node->leftChild, node, rest);
+}
+/*
+Split nodes function divides a detached subtree into the values below a key and the values above it, following the path to the key and joining the subtrees that
+hang off each side of the path back together. A node equal to the key is taken out of both and returned on its own, with no children. Each node is compared
+before its children are cut loose, so if the compare throws, the nodes on the path are relinked as they were and the subtree is left whole.
 
-    @param[in]: Node to be deleted, along with all children.
-    @return: The deletion of said nodes, usually destroying the tree.
-    */
-    void postOrderDelete(BinaryTreeNode* node)
+@param[in]: The root of the subtree, possibly null, the key, and where to put the roots of the lower and upper parts.
+@return: The node equal to the key, or null if there is none, or whatever the compare throws, with the subtree unchanged.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::splitNodes(BinaryTreeNode* node, const DATA_TYPE& key, BinaryTreeNode*& less, BinaryTreeNode*& greater) const
+{
+    if (!node)
     {
-        if (!node)
-            return;
-
-        postOrderDelete(node->leftChild);
-        postOrderDelete(node->rightChild);
-        delete node;
+        less = greater = nullptr;
+        return nullptr;
+    }
+    int result = compare(node->nodeValue, key);
+    BinaryTreeNode* left = detach(node->leftChild);
+    BinaryTreeNode* right = detach(node->rightChild);
+    if (result == 0)
+    {
+        less = left;
+        greater = right;
+        node->leftChild = node->rightChild = node->parent = nullptr;
+        return node;
     }
 
-    void rotateRight(BinaryTreeNode* node);
-    void rotateLeft(BinaryTreeNode* node);
-    int getHeight(BinaryTreeNode* node);
+    BinaryTreeNode* found = nullptr;
+    BinaryTreeNode* middle = nullptr;
+    try
+    {
+        if (result > 0)
+            found = splitNodes(left, key, less, middle);
+        else
+            found = splitNodes(right, key, middle, greater);
+    }
+    catch (...)
+    {
+        linkNode(left, node, right);
+        throw;
+    }
+    if (result > 0)
+        greater = joinNodes(middle, node, right);
+    else
+        less = joinNodes(left, node, middle);
+    return found;
+}
+/*
+Combine nodes function runs a union, intersection, or difference of two detached subtrees. The root of the second splits the first, the two lower parts and the
+two upper parts are combined recursively, and the results are joined back around the root when the operation keeps its value. A value found in both trees keeps
+the node of the first tree. Nodes that drop out of the result are put on the discarded list, whole subtrees at a time when one side runs out, to be freed once
+the operation is over.
 
-public:
-    //Public function declarations, and definitions for simple functions.
-    BinarySearchTree(int (*cmp)(const DATA_TYPE& item1, const DATA_TYPE& item2));
-    ~BinarySearchTree();
+While forks remain and both trees are tall, the upper parts are combined on another thread while this one combines the lower parts. Each fork halves the forks
+left to its two halves, so the threads used stay close to the hardware threads available. When no thread can be started, the upper parts are combined on this
+thread instead.
 
-    void insert(DATA_TYPE item);
-    void remove(const DATA_TYPE& item);
-    DATA_TYPE search(const DATA_TYPE& item);
-    void insertRebalance(BinaryTreeNode* offBalanceNode, BinaryTreeNode* preNode, BinaryTreeNode* prepreNode);
-    void removeRebalance(BinaryTreeNode* offbalanceNode, BinaryTreeNode* preNode, BinaryTreeNode* prepreNode);
-    /*
-    Count function simply returns nodeCount to display number of nodes in a tree.
+If the compare throws, every node of both subtrees, whether already combined or not, is on the discarded list when the exception leaves.
 
-    @param[in]: Nothing.
-    @return: The current number of nodes in a tree.
+@param[in]: The roots of the two subtrees, possibly null, the discarded list of this thread, and the forks left.
+@return: The root of the combined subtree, detached, or null if it is empty.
 */
-    int count()
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::SetOperation OPERATION>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::combineNodes(BinaryTreeNode* first, BinaryTreeNode* second, vector<BinaryTreeNode*>& discarded, int forkDepth) const
+{
+    if (!first || !second)
     {
-        return nodeCount;
+        BinaryTreeNode* kept = OPERATION == SetOperation::UNION ? (first ? first : second) : OPERATION == SetOperation::DIFFERENCE ? first : nullptr;
+        for (BinaryTreeNode* node : { first, second })
+        {
+            if (node && node != kept)
+                discarded.push_back(node);
+        }
+        return kept;
     }
-    /*
-    In order function uses the visit function to call on privateInOrder, serving as a public call to the InOrder traversal.
 
-    @param[in]: A function pointer to visit, meant to visit a certain item.
-    @return: Nothing. Calls on private function to carry out task.
-    */
-    void inOrder(void (*visit)(const DATA_TYPE& item))
+    bool parallel = forkDepth > 0 && min(subtreeHeight(first), subtreeHeight(second)) >= PARALLEL_HEIGHT;
+    BinaryTreeNode* secondLeft = detach(second->leftChild);
+    BinaryTreeNode* secondRight = detach(second->rightChild);
+    second->leftChild = second->rightChild = nullptr;
+    BinaryTreeNode* less = nullptr;
+    BinaryTreeNode* greater = nullptr;
+    BinaryTreeNode* duplicate = nullptr;
+    try
     {
-        privateInOrder(root, visit);
+        duplicate = splitNodes(first, second->nodeValue, less, greater);
     }
-
-    /*
-    Public rotation functions are simply accessors to the private rotation functions. These functions find the node that is meant to be rotated, and call on their
-    private counterparts to carry out the operation.
-
-    @param[in]: The value of the node being rotated.
-    @return: A rotated node in the tree.
-    */
-    void rightRotatePublic(DATA_TYPE item)
+    catch (...)
     {
-        BinaryTreeNode* rotatedNode = findParentOrDuplicate(item);
-        rotateRight(rotatedNode);
+        for (BinaryTreeNode* piece : { first, second, secondLeft, secondRight })
+        {
+            if (piece)
+                discarded.push_back(piece);
+        }
+        throw;
     }
-    void leftRotatePublic(DATA_TYPE item)
+
+    BinaryTreeNode* middle = nullptr;
+    if (OPERATION == SetOperation::UNION)
+        middle = duplicate ? duplicate : second;
+    else if (OPERATION == SetOperation::INTERSECTION)
+        middle = duplicate;
+    if (second != middle)
+        discarded.push_back(second);
+    if (duplicate && duplicate != middle)
+        discarded.push_back(duplicate);
+
+    //Subtrees are set to null as they are handed to a recursive call, which discards them itself if it throws, so those left are the ones to discard here.
+    BinaryTreeNode* left = nullptr;
+    BinaryTreeNode* right = nullptr;
+    vector<BinaryTreeNode*> rightDiscarded;
+    future<BinaryTreeNode*> rightTask;
+    try
     {
-        BinaryTreeNode* rotatedNode = findParentOrDuplicate(item);
-        rotateLeft(rotatedNode);
+        if (parallel)
+        {
+            rightTask = forkTask([this, &rightDiscarded, upperFirst = greater, upperSecond = secondRight, forkDepth]() {
+                return combineNodes<OPERATION>(upperFirst, upperSecond, rightDiscarded, forkDepth - 1);
+            });
+        }
+        if (rightTask.valid())
+            greater = secondRight = nullptr;
+        left = combineNodes<OPERATION>(exchange(less, nullptr), exchange(secondLeft, nullptr), discarded, rightTask.valid() ? forkDepth - 1 : 0);
+        if (rightTask.valid())
+            right = rightTask.get();
+        else
+            right = combineNodes<OPERATION>(exchange(greater, nullptr), exchange(secondRight, nullptr), discarded, 0);
     }
-    /*
-    Return height function is used in test cases to check the heights of key nodes to ensure operations have been done correctly. Function finds node and then returns
-    the height of the node.
-
-    @param[in]: Value of the node being searched for for its height.
-    @return: The height of the node searched for.
-    */
-    int returnHeight(DATA_TYPE item)
+    catch (...)
     {
-        BinaryTreeNode* node = findParentOrDuplicate(item);
-        return node->treeHeight;
+        if (rightTask.valid())
+        {
+            try
+            {
+                right = rightTask.get();
+            }
+            catch (...)
+            {
+            }
+        }
+        discarded.insert(discarded.end(), rightDiscarded.begin(), rightDiscarded.end());
+        for (BinaryTreeNode* piece : { less, secondLeft, greater, secondRight, left, right, middle })
+        {
+            if (piece)
+                discarded.push_back(piece);
+        }
+        throw;
     }
-};
+    discarded.insert(discarded.end(), rightDiscarded.begin(), rightDiscarded.end());
+    return middle ? joinNodes(left, middle, right) : joinTwo(left, right);
+}
 /*
-Constructor for the tree object takes in a function pointer to the compare function in main, and uses it to facilitate the binary search property. Also sets the 
-initial conditions for an empty search tree.
+Combine with function runs a set operation between this tree and another, taking the other tree's nodes. Combine root function runs it against a detached
+subtree, then frees the nodes left out of the result. The count of the result is the two counts less the nodes freed, so no walk of the result is needed. When
+asked, the values of the freed nodes are moved out first, which for a union are exactly the duplicates of the second tree it rejected.
 
-@param[in]: Constructor takes function pointer to compare function in main.
-@return: An empty binary search tree.
+If the compare throws partway, the subtrees taken apart cannot be put back in order without comparing again, so every node of both trees is freed and this tree
+is left empty, rather than leaking them.
+
+@param[in]: The other tree, left empty afterwards, or the root and count of the subtree, the forks allowed, and where to add rejected values, possibly null.
+@return: Nothing, or whatever the compare throws, with this tree left empty. This tree holds the result of the operation.
 */
-template <typename DATA_TYPE>
-BinarySearchTree<DATA_TYPE>::BinarySearchTree(int (*cmp)(const DATA_TYPE& item1, const DATA_TYPE& item2))
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::SetOperation OPERATION>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::combineWith(BinarySearchTree& other)
 {
-    compare = cmp;
-    nodeCount = 0;
+    if (this == &other)
+    {
+        if (OPERATION == SetOperation::DIFFERENCE)
+            clear();
+        return;
+    }
+    int otherCount = other.nodeCount;
+    BinaryTreeNode* otherRoot = takeNodes(other);
+    combineRoot<OPERATION>(otherRoot, otherCount, forkDepthFor(true), nullptr);
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::SetOperation OPERATION>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::combineRoot(BinaryTreeNode* otherRoot, int otherCount, int forkDepth, vector<DATA_TYPE>* rejected)
+{
+    int combinedCount = nodeCount + otherCount;
+    BinaryTreeNode* thisRoot = detach(root);
     root = nullptr;
+    nodeCount = 0;
+
+    vector<BinaryTreeNode*> discarded;
+    try
+    {
+        root = combineNodes<OPERATION>(thisRoot, otherRoot, discarded, forkDepth);
+        for (BinaryTreeNode* node : discarded)
+            combinedCount -= countNodes(node);
+        nodeCount = combinedCount;
+        if (rejected)
+        {
+            for (BinaryTreeNode* node : discarded)
+            {
+                for (BinaryTreeNode* current = leftmostNode(node); current; current = successorNode(current))
+                    rejected->push_back(std::move(current->nodeValue));
+            }
+        }
+    }
+    catch (...)
+    {
+        for (BinaryTreeNode* node : discarded)
+            postOrderDelete(node);
+        throw;
+    }
+    for (BinaryTreeNode* node : discarded)
+        postOrderDelete(node);
 }
 /*
-Destructor runs postOrderDelete starting at the root to fully empty a binary search tree.
+Take nodes function empties another tree and returns its nodes as a detached subtree for this tree to use. When the two node allocators do not compare equal,
+as with two PoolAllocator trees, nodes cannot change hands, so the values are copied into a balanced subtree of this tree's nodes instead.
 
-@param[in]: Nothing.
-@return: A newly empty tree.
+@param[in]: The other tree, left empty afterwards.
+@return: The root of a detached subtree holding the other tree's values, possibly null.
 */
-template <typename DATA_TYPE>
-BinarySearchTree<DATA_TYPE>::~BinarySearchTree()
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::takeNodes(BinarySearchTree& other)
 {
-    postOrderDelete(root);
+    BinaryTreeNode* taken = nullptr;
+    if (nodeAllocator == other.nodeAllocator)
+    {
+        taken = detach(other.root);
+        other.root = nullptr;
+        other.nodeCount = 0;
+        return taken;
+    }
+    Iterator next = other.begin();
+    taken = buildBalanced(next, (size_t)other.nodeCount);
+    other.clear();
+    return taken;
 }
-
 /*
-Insert function takes in a value and creates a new node with that value. The node is inserted into the tree where it fits best based on the binary search property, or 
-at the root if the tree is empty. Exception is thrown if the inserted item already exists. After inserting, a loop travels back up the tree from the point of insertion,
-and updates the heights until it either reaches the root or finds a case where rebalancing using a function call is necessary.
+Join function appends another tree whose values all lie above the values of this tree, in time proportional to the difference in their heights rather than
+inserting each value. Split function moves the values not less than a key into another tree, replacing its contents, and keeps the values below the key.
 
-@param[in]: An item to store in a new node.
-@return: The tree with the new node, potentially rebalanced.
+Split has to count the values it moves, which takes O(log n) with order statistics enabled and a walk over the moved values otherwise.
+
+@param[in]: The other tree, left empty by join, or the key and the tree to receive the upper values for split.
+@return: Nothing, or an exception from join if the values of the two trees overlap.
 */
-template <typename DATA_TYPE>
-void BinarySearchTree<DATA_TYPE>::insert(DATA_TYPE item)
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::join(BinarySearchTree& other)
 {
-    //Empty tree case
-    if (!root)
+    if (this == &other || !other.root)
+        return;
+    if (root && compare(rightmostNode(root)->nodeValue, leftmostNode(other.root)->nodeValue) >= 0)
+        throw UnsortedInputException(__LINE__, "Joined tree values are not all above this tree. Unable to join");
+    int joinedCount = nodeCount + other.nodeCount;
+    BinaryTreeNode* otherRoot = takeNodes(other);
+    root = joinTwo(detach(root), otherRoot);
+    nodeCount = joinedCount;
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::split(const DATA_TYPE& key, BinarySearchTree& upper)
+{
+    if (this == &upper)
+        return;
+    upper.clear();
+    BinaryTreeNode* less = nullptr;
+    BinaryTreeNode* greater = nullptr;
+    BinaryTreeNode* found = splitNodes(detach(root), key, less, greater);
+    if (found)
+        greater = joinNodes(nullptr, found, greater);
+    root = less;
+
+    int upperCount = 0;
+    if constexpr (ORDER_STATISTICS)
+        upperCount = subtreeSize(greater);
+    else
+        upperCount = countNodes(greater);
+    nodeCount -= upperCount;
+    if (nodeAllocator == upper.nodeAllocator)
     {
-        root = new BinaryTreeNode();
-        root->nodeValue = item;
-        root->treeHeight = 1;
-        nodeCount++;
+        upper.root = greater;
+        upper.nodeCount = upperCount;
         return;
     }
-
-    // Find the parent node, or identify a duplicate entry
-    BinaryTreeNode* searchNode = findParentOrDuplicate(item);
-    if (!compare(searchNode->nodeValue, item)) // Check to see if the item already exists
+    try
     {
-        // Duplicate item detected, throw an exception
-        DuplicateItemException exception(__LINE__, "Duplicate item detected. Unable to insert");
-        throw exception;
+        upper.assignSorted(Iterator(this, greater ? leftmostNode(greater) : nullptr), Iterator(this, nullptr));
     }
+    catch (...)
+    {
+        root = joinTwo(root, greater);
+        nodeCount += upperCount;
+        throw;
+    }
+    postOrderDelete(greater);
+}
+/*
+Union with, intersect with, and difference with functions replace this tree with its union, intersection, or difference with another tree, using the join-based
+algorithms in O(m log(n/m + 1)) comparisons for trees of sizes m and n, m the smaller. The other tree is emptied and its nodes reused where the result keeps
+them. Values found in both trees keep this tree's copy. The recursive halves of large operations run in parallel, so the compare policy must be safe to call from
+several threads. A compare that throws leaves both trees empty.
 
-    // Create new node
-    BinaryTreeNode* node = new BinaryTreeNode();
-    node->nodeValue = item;
-    node->treeHeight = 1;
-
-    // Link the parent
-    node->parent = searchNode;
+@param[in]: The other tree, left empty afterwards.
+@return: Nothing. This tree holds the result.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::unionWith(BinarySearchTree& other)
+{
+    combineWith<SetOperation::UNION>(other);
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::intersectWith(BinarySearchTree& other)
+{
+    combineWith<SetOperation::INTERSECTION>(other);
+}
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+void BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::differenceWith(BinarySearchTree& other)
+{
+    combineWith<SetOperation::DIFFERENCE>(other);
+}
+/*
+Sorted length function checks that a batch is in ascending order, and counts it. Equal neighbors are allowed, and reported, since a batch may repeat a key.
 
-    // Determine if the node will be a left or right child
-    // Attach the node to the appropriate side
-    if (compare(searchNode->nodeValue, item) == 1)
-        searchNode->leftChild = node;
-    else
-        searchNode->rightChild = node;
+@param[in]: A range of forward iterators over the batch, and where to report whether any item repeats its neighbor.
+@return: The number of items in the batch, or an exception if it is not in ascending order.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename ITERATOR>
+size_t BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::sortedLength(ITERATOR first, ITERATOR last, bool& repeated) const
+{
+    repeated = false;
+    if (first == last)
+        return 0;
+    size_t itemCount = 1;
+    ITERATOR previous = first;
+    for (ITERATOR current = std::next(first); current != last; ++current, ++previous, itemCount++)
+    {
+        int result = compare(*previous, *current);
+        if (result > 0)
+            throw UnsortedInputException(__LINE__, "Batch is not in ascending order. Unable to apply batch");
+        repeated = repeated || result == 0;
+    }
+    return itemCount;
+}
+/*
+Insert batch function adds a sorted batch in one pass rather than a descent and rebalance walk per item. The batch is built into a balanced subtree in linear
+time and merged in with the join-based union, so a batch of k items costs O(k log(n/k + 1)) comparisons. When asked, the halves of large batches are merged in
+parallel, which calls the compare policy from several threads, so only callers whose policy is safe for that should ask. Nodes are only created before the
+merge starts, so any allocator is safe to use in parallel.
 
-    nodeCount++;
+Items already in the tree, or repeated within the batch, are not inserted. They are added to the duplicates list in ascending order if one is given, instead of
+each throwing DuplicateItemException.
 
-    //Rebalance checks
-    BinaryTreeNode* previousNode = nullptr;
-    BinaryTreeNode* prePreviousNode = nullptr;
-    int balanceFactor = 0;
+If the compare throws during the merge, this tree has already been taken apart and cannot be put back in order without comparing again, so every node of the
+tree and the batch is freed and the tree is left empty, as removeBatch does. An exception while the duplicates are moved out or sorted afterwards leaves the
+merged tree in place.
 
-    while (node->parent)
+@param[in]: A range of forward iterators over the batch in ascending order, where to add the duplicates, possibly null, and whether to run in parallel.
+@return: The number of items inserted, or an exception before anything changes if the batch is not in ascending order, or whatever the compare throws during
+    the merge, with the tree left empty.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename ITERATOR>
+int BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::insertBatch(ITERATOR first, ITERATOR last, vector<DATA_TYPE>* duplicates, bool parallel)
+{
+    bool repeated = false;
+    size_t batchCount = sortedLength(first, last, repeated);
+    size_t reported = duplicates ? duplicates->size() : 0;
+    BinaryTreeNode* batchRoot = nullptr;
+    if (!repeated)
     {
-        //Traversal up tree
-        prePreviousNode = previousNode;
-        previousNode = node;
-        node = node->parent;
-        
-        //Calculation of balance factor
-        int rightTreeHeight = 0;
-        int leftTreeHeight = 0;
-        BinaryTreeNode* right = node->rightChild;
-        BinaryTreeNode* left = node->leftChild;
-        if (right != nullptr)
-        {
-            rightTreeHeight = right->treeHeight;
-        }
-        if (left != nullptr)
-        {
-            leftTreeHeight = left->treeHeight;
-        }
-        balanceFactor = rightTreeHeight - leftTreeHeight;
-        //Check of balance factor in case of rebalancing.
-        if (balanceFactor < -1 || balanceFactor > 1)
+        batchRoot = buildBalanced(first, batchCount);
+    }
+    else
+    {
+        vector<DATA_TYPE> uniqueItems;
+        for (ITERATOR current = first; current != last; ++current)
         {
-            insertRebalance(node, previousNode, prePreviousNode);
-            break;
+            if (!uniqueItems.empty() && compare(uniqueItems.back(), *current) == 0)
+            {
+                if (duplicates)
+                    duplicates->push_back(*current);
+            }
+            else
+            {
+                uniqueItems.push_back(*current);
+            }
         }
-        //Update height if no rebalance needed.
-        node->treeHeight = getHeight(node);
+        batchCount = uniqueItems.size();
+        auto next = make_move_iterator(uniqueItems.begin());
+        batchRoot = buildBalanced(next, batchCount);
     }
+
+    int previousCount = nodeCount;
+    combineRoot<SetOperation::UNION>(batchRoot, (int)batchCount, forkDepthFor(parallel), duplicates);
+    if (duplicates)
+        sort(duplicates->begin() + reported, duplicates->end(), [this](const DATA_TYPE& item1, const DATA_TYPE& item2) { return compare(item1, item2) < 0; });
+    return nodeCount - previousCount;
 }
 /*
-Delete function takes in a value, and finds and deletes the node holding that value if it exists. If not, an item not found exception will be thrown. Function checks for
-simple or complex deletion case, and handles it accordingly. Afterwards, delete loops back up the tree starting from the parent of the deleted node until it reaches
-the root, rebalancing the tree in any cases where the balance factor of a node is off.
+Remove batch function removes a sorted batch in one pass. The middle item of the batch splits the tree, the lower and upper halves of the batch are removed from
+the lower and upper parts recursively, and the parts are joined back together, so no batch tree is built and a batch of k items costs O(k log(n/k + 1))
+comparisons. The removed nodes are freed once the tree is whole again. When asked, the halves of large batches run in parallel, with the same requirement on
+the compare policy as insertBatch.
 
-@param[in]: An item to delete out of the tree.
-@return: The tree without the node, potentially rebalanced based on deletion changes.
+Items not in the tree, or repeated within the batch, are added to the not found list in ascending order if one is given, instead of each throwing
+ItemNotFoundException.
+
+If the compare throws once the tree has been taken apart, its parts cannot be put back in order without comparing again, so every node is freed and the tree is
+left empty, rather than leaking them.
+
+@param[in]: A range of forward iterators over the batch in ascending order, where to add the items not found, possibly null, and whether to run in parallel.
+@return: The number of items removed, or an exception before anything changes if the batch is not in ascending order, or whatever the compare throws, with the
+    tree left empty.
 */
-template <typename DATA_TYPE>
-void BinarySearchTree<DATA_TYPE>::remove(const DATA_TYPE& item)
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename ITERATOR>
+int BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::removeBatch(ITERATOR first, ITERATOR last, vector<DATA_TYPE>* notFound, bool parallel)
 {
-    // Find the item to remove
-    BinaryTreeNode* searchResult = findParentOrDuplicate(item);
-    if (!searchResult || compare(searchResult->nodeValue, item))
+    bool repeated = false;
+    size_t batchCount = sortedLength(first, last, repeated);
+    vector<BinaryTreeNode*> discarded;
+    try
     {
-        // Throw item not found exception
-        throw ItemNotFoundException(__LINE__, "Item was not found");
+        root = removeSorted(detach(root), first, batchCount, discarded, notFound, forkDepthFor(parallel));
     }
-
-    // Check to see if it is a simple or hard case
-    if (searchResult->leftChild && searchResult->rightChild)
+    catch (...)
     {
-        // Find the immediate predecessor
-        BinaryTreeNode* current = searchResult->leftChild;
-        while (current->rightChild)
-            current = current->rightChild;
-        // Swap the data items
-        DATA_TYPE tmp = searchResult->nodeValue;
-        searchResult->nodeValue = current->nodeValue;
-        current->nodeValue = tmp;
-
-        // Set searchResult to the immediate predecessor
-        searchResult = current;
+        root = nullptr;
+        nodeCount = 0;
+        for (BinaryTreeNode* node : discarded)
+            postOrderDelete(node);
+        throw;
     }
+    for (BinaryTreeNode* node : discarded)
+        destroyNode(node);
+    nodeCount -= (int)discarded.size();
+    return (int)discarded.size();
+}
+/*
+Remove sorted function removes the items of a sorted batch from a detached subtree. Each half of the batch only meets the part of the subtree on its side of the
+middle item, so the recursion ends as soon as either runs out. Removed nodes go on the discarded list, and items not found are added in order: those of the
+lower half, then the middle item, then those of the upper half. The upper half runs on the calling thread when no thread can be started for it.
 
-    BinaryTreeNode* child = searchResult->rightChild ? searchResult->rightChild : searchResult->leftChild;
-    BinaryTreeNode* parent = searchResult->parent;
+If the compare throws, every node of the subtree, removed or not, is on the discarded list when the exception leaves.
 
-    //Check for setting the new child to the proper child pointer of parent, and linking child to parent if it exists. Also setting child to root if no parent exists.
-    if (parent)
+@param[in]: The root of the subtree, possibly null, the start and length of the batch, the discarded list of this thread, where to add the items not found,
+    possibly null, and the forks left.
+@return: The root of the remaining subtree, detached, or null if it is empty.
+*/
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename ITERATOR>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode*
+BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::removeSorted(BinaryTreeNode* node, ITERATOR first, size_t count, vector<BinaryTreeNode*>& discarded,
+    vector<DATA_TYPE>* notFound, int forkDepth) const
+{
+    if (count == 0)
+        return node;
+    if (!node)
     {
-        BinaryTreeNode** side = parent->rightChild == searchResult ? &(parent->rightChild) : &(parent->leftChild);
-        *side = child;
-        if (child)
-            child->parent = parent;
+        if (notFound)
+            notFound->insert(notFound->end(), first, std::next(first, count));
+        return nullptr;
     }
-    else
+
+    bool parallel = forkDepth > 0 && subtreeHeight(node) >= PARALLEL_HEIGHT && count >= ((size_t)1 << (PARALLEL_HEIGHT / 2));
+    size_t leftCount = count / 2;
+    ITERATOR middle = std::next(first, leftCount);
+    BinaryTreeNode* less = nullptr;
+    BinaryTreeNode* greater = nullptr;
+    BinaryTreeNode* found = nullptr;
+    try
     {
-        root = child;
+        found = splitNodes(node, *middle, less, greater);
     }
-
-    delete searchResult;
-
-    nodeCount--;
-
-    //Rebalance checks
-    BinaryTreeNode* previousNode = nullptr;
-    BinaryTreeNode* prePreviousNode = nullptr;
-    int balanceFactor = 0;
-
-    while (parent)
+    catch (...)
     {
-        //Calculate new height
-        parent->treeHeight = getHeight(parent);
-
-        //Calculate balance factor.
-        int rightTreeHeight = 0;
-        int leftTreeHeight = 0;
-        BinaryTreeNode* right = parent->rightChild;
-        BinaryTreeNode* left = parent->leftChild;
-        if (right != nullptr)
+        discarded.push_back(node);
+        throw;
+    }
+    if (found)
+        discarded.push_back(found);
+
+    //Subtrees are set to null as they are handed to a recursive call, which discards them itself if it throws, so those left are the ones to discard here.
+    BinaryTreeNode* left = nullptr;
+    BinaryTreeNode* right = nullptr;
+    vector<BinaryTreeNode*> rightDiscarded;
+    vector<DATA_TYPE> rightNotFound;
+    future<BinaryTreeNode*> rightTask;
+    try
+    {
+        if (parallel)
         {
-            rightTreeHeight = right->treeHeight;
+            rightTask = forkTask([&, upper = greater]() {
+                return removeSorted(upper, std::next(middle), count - leftCount - 1, rightDiscarded, notFound ? &rightNotFound : nullptr, forkDepth - 1);
+            });
         }
-        if (left != nullptr)
+        if (rightTask.valid())
+            greater = nullptr;
+        left = removeSorted(exchange(less, nullptr), first, leftCount, discarded, notFound, rightTask.valid() ? forkDepth - 1 : 0);
+        if (notFound && !found)
+            notFound->push_back(*middle);
+        if (rightTask.valid())
         {
-            leftTreeHeight = left->treeHeight;
+            right = rightTask.get();
+            if (notFound)
+                notFound->insert(notFound->end(), make_move_iterator(rightNotFound.begin()), make_move_iterator(rightNotFound.end()));
         }
-        balanceFactor = rightTreeHeight - leftTreeHeight;
-        //Check for any necessary rebalance.
-        if (balanceFactor < -1 || balanceFactor > 1)
+        else
         {
-            removeRebalance(parent, previousNode, prePreviousNode);
+            right = removeSorted(exchange(greater, nullptr), std::next(middle), count - leftCount - 1, discarded, notFound, 0);
         }
-        //Traversal up tree.
-        prePreviousNode = previousNode;
-        previousNode = parent;
-        parent = parent->parent;
     }
-}
-/*
-Search function scans through tree and returns searched-for value, or an exception if the item was not found.
-
-@param[in]: An item to search for in tree.
-@return: The value of the node searched for.
-*/
-template <typename DATA_TYPE>
-DATA_TYPE BinarySearchTree<DATA_TYPE>::search(const DATA_TYPE& item)
-{
-    BinaryTreeNode* searchResult = findParentOrDuplicate(item);
-    if (!searchResult || compare(searchResult->nodeValue, item))
+    catch (...)
     {
-        // Throw ItemNotFoundException
-        throw ItemNotFoundException(__LINE__, "Item was not found");
+        if (rightTask.valid())
+        {
+            try
+            {
+                right = rightTask.get();
+            }
+            catch (...)
+            {
+            }
+        }
+        discarded.insert(discarded.end(), rightDiscarded.begin(), rightDiscarded.end());
+        for (BinaryTreeNode* piece : { less, greater, left, right })
+        {
+            if (piece)
+                discarded.push_back(piece);
+        }
+        throw;
     }
-
-    return searchResult->nodeValue;
+    discarded.insert(discarded.end(), rightDiscarded.begin(), rightDiscarded.end());
+    return joinTwo(left, right);
 }
 /*
 Insert rebalance function takes in the previous few nodes after traveling up the tree, and determines which case of insertion rebalancing is needed using branching
@@ -457,9 +2709,10 @@ conditionals. It then calls on certain rotation functions for certain nodes base
 @param[in]: The node with an off-balance factor, the previous visited node, and the node visited before that.
 @return: The tree rebalanced after insertion.
 */
-template <typename DATA_TYPE>
-void BinarySearchTree<DATA_TYPE>::insertRebalance(BinaryTreeNode* offbalanceNode, BinaryTreeNode* preNode, BinaryTreeNode* prepreNode)
+template <typename TREE, typename NODE, bool ORDER_STATISTICS>
+void AVLTreeLinks<TREE, NODE, ORDER_STATISTICS>::insertRebalance(NODE* offbalanceNode, NODE* preNode, NODE* prepreNode)
 {
+    AVL_COUNT_STAT(insertRebalances);
     if (offbalanceNode->leftChild == preNode)
     {
         if (preNode->leftChild == prepreNode)
@@ -486,26 +2739,30 @@ void BinarySearchTree<DATA_TYPE>::insertRebalance(BinaryTreeNode* offbalanceNode
     }
 }
 /*
-Remove rebalance function takes in the previous few nodes after traveling up the tree, and determines which case of deletion rebalancing is needed using branching
-conditionals. It then calls on certain rotation functions for certain nodes based on the case.
+Remove rebalance function takes in the off-balance node found after traveling up the tree, and determines which case of deletion rebalancing is needed from the
+heights of its subtrees using branching conditionals. It then calls on certain rotation functions for certain nodes based on the case.
 
-@param[in]: The node with an off-balance factor, the previous visited node, and the node visited before that.
-@return: The tree rebalanced after deletion.
+@param[in]: The node with an off-balance factor.
+@return: The tree rebalanced after deletion, and the node now at the top of the rebalanced subtree.
 */
-template <typename DATA_TYPE>
-void BinarySearchTree<DATA_TYPE>::removeRebalance(BinaryTreeNode* offbalanceNode, BinaryTreeNode* preNode, BinaryTreeNode* prepreNode)
+template <typename TREE, typename NODE, bool ORDER_STATISTICS>
+NODE* AVLTreeLinks<TREE, NODE, ORDER_STATISTICS>::removeRebalance(NODE* offbalanceNode)
 {
+    AVL_COUNT_STAT(removeRebalances);
     int balanceFactor = 0;
     int leftTreeHeight = 0;
     int rightTreeHeight = 0;
-    if (offbalanceNode->leftChild == preNode)
+    //The heavy side is read from the subtree heights, since preNode is null when the removed node left no child behind and would match an empty side.
+    int offbalanceRightHeight = offbalanceNode->rightChild ? offbalanceNode->rightChild->treeHeight : 0;
+    int offbalanceLeftHeight = offbalanceNode->leftChild ? offbalanceNode->leftChild->treeHeight : 0;
+    if (offbalanceRightHeight > offbalanceLeftHeight)
     {
         //Recalculate balance factor
-        BinaryTreeNode* rightChild = offbalanceNode->rightChild;
+        NODE* rightChild = offbalanceNode->rightChild;
         if (rightChild != nullptr)
         {
-            BinaryTreeNode* rightrightChild = rightChild->rightChild;
-            BinaryTreeNode* rightleftChild = rightChild->leftChild;
+            NODE* rightrightChild = rightChild->rightChild;
+            NODE* rightleftChild = rightChild->leftChild;
             if (rightrightChild != nullptr)
             {
                 rightTreeHeight = rightrightChild->treeHeight;
@@ -521,22 +2778,21 @@ void BinarySearchTree<DATA_TYPE>::removeRebalance(BinaryTreeNode* offbalanceNode
         if (balanceFactor == 0 || balanceFactor == 1)
         {
             rotateLeft(rightChild);
+            return rightChild;
         }
-        else if (balanceFactor == -1)
-        {
-            BinaryTreeNode* rightleftChild = rightChild->leftChild;
-            rotateRight(rightleftChild);
-            rotateLeft(rightleftChild);
-        }
+        NODE* rightleftChild = rightChild->leftChild;
+        rotateRight(rightleftChild);
+        rotateLeft(rightleftChild);
+        return rightleftChild;
     }
-   else if (offbalanceNode->rightChild == preNode)
+    else
     {
         //Recalculate balance factor
-        BinaryTreeNode* leftChild = offbalanceNode->leftChild;
+        NODE* leftChild = offbalanceNode->leftChild;
         if (leftChild != nullptr)
         {
-            BinaryTreeNode* leftrightChild = leftChild->rightChild;
-            BinaryTreeNode* leftleftChild = leftChild->leftChild;
+            NODE* leftrightChild = leftChild->rightChild;
+            NODE* leftleftChild = leftChild->leftChild;
             if (leftrightChild != nullptr)
             {
                 rightTreeHeight = leftrightChild->treeHeight;
@@ -552,40 +2808,48 @@ void BinarySearchTree<DATA_TYPE>::removeRebalance(BinaryTreeNode* offbalanceNode
         if (balanceFactor == 0 || balanceFactor == -1)
         {
             rotateRight(leftChild);
+            return leftChild;
         }
-        else if (balanceFactor == 1)
-        {
-            BinaryTreeNode* leftrightChild = leftChild->rightChild;
-            rotateLeft(leftrightChild);
-            rotateRight(leftrightChild);
-        }
+        NODE* leftrightChild = leftChild->rightChild;
+        rotateLeft(leftrightChild);
+        rotateRight(leftrightChild);
+        return leftrightChild;
     }
 }
 /*
 Find parent or duplicate function is used for tree traversal, and locating a particular node for manipulation or reading. Following the binary search property,
 it traverses the tree until finding its object.
 
-@param[in]: The item of the node being searched for.
+@param[in]: The item of the node being searched for, or a key the compare policy can compare against stored values, and where to store the result of the last
+    comparison made, so callers know whether the node returned is a duplicate (0), or the item belongs to its left (positive) or right (negative).
 @return: The node or its parent being searched for.
 */
-template <typename DATA_TYPE>
-typename BinarySearchTree<DATA_TYPE>::BinaryTreeNode* BinarySearchTree<DATA_TYPE>::findParentOrDuplicate(const DATA_TYPE& item)
+template <typename DATA_TYPE, typename Compare, typename Allocator, bool ORDER_STATISTICS>
+template <typename KEY>
+typename BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::BinaryTreeNode* BinarySearchTree<DATA_TYPE, Compare, Allocator, ORDER_STATISTICS>::findParentOrDuplicate(const KEY& item, int& lastComparison) const
 {
     BinaryTreeNode* current = root;
     BinaryTreeNode* parent = current;
+    lastComparison = 0;
+    int depth = 0;
 
     while (current)
     {
         parent = current;
-        if (!compare(current->nodeValue, item))
+        depth++;
+        AVL_TOUCH_NODES(1);
+        // One comparison per level decides both the duplicate check and the direction.
+        lastComparison = compare(current->nodeValue, item);
+        if (!lastComparison)
             break;
         // Next, decide if we need to go left or right.
-        if (compare(current->nodeValue, item) == 1) // Go left
+        if (lastComparison > 0) // Go left
             current = current->leftChild;
-        else // Go right. Duplicate is detected in the test of the while
+        else // Go right
             current = current->rightChild;
     }
 
+    AVL_RECORD_DESCENT(depth);
     return parent;
 }
 /*
@@ -595,15 +2859,16 @@ case if the parent of the node rotated is the root.
 @param[in]: The node being rotated.
 @return: The tree with the nodes rotated to the right.
 */
-template <typename TYPE>
-void BinarySearchTree<TYPE>::rotateRight(BinaryTreeNode* node)
+template <typename TREE, typename NODE, bool ORDER_STATISTICS>
+void AVLTreeLinks<TREE, NODE, ORDER_STATISTICS>::rotateRight(NODE* node)
 {
-    BinaryTreeNode* parent = node->parent;
-    BinaryTreeNode* noderightChild = node->rightChild;
+    AVL_COUNT_STAT(rightRotations);
+    NODE* parent = node->parent;
+    NODE* noderightChild = node->rightChild;
 
-    if (parent != root)
+    if (parent != tree().root)
     {
-        BinaryTreeNode* grandparent = parent->parent;
+        NODE* grandparent = parent->parent;
         node->parent = grandparent;
         if (grandparent->leftChild == parent)
         {
@@ -623,7 +2888,7 @@ void BinarySearchTree<TYPE>::rotateRight(BinaryTreeNode* node)
     }
     else
     {
-        root = node;
+        tree().root = node;
         parent->leftChild = noderightChild;
         node->rightChild = parent;
         node->parent = nullptr;
@@ -636,6 +2901,9 @@ void BinarySearchTree<TYPE>::rotateRight(BinaryTreeNode* node)
 
     parent->treeHeight = getHeight(parent);
     node->treeHeight = getHeight(node);
+    updateSize(parent);
+    updateSize(node);
+    AVL_TOUCH_NODES(2);
 }
 /*
 Left rotate function carries out the algorithm for a left rotation about the node used as a parameter, moving the node up the tree. A conditional accounts for a special
@@ -644,15 +2912,16 @@ case if the parent of the node rotated is the root.
 @param[in]: The node being rotated.
 @return: The tree with the nodes rotated to the left.
 */
-template <typename TYPE>
-void BinarySearchTree<TYPE>::rotateLeft(BinaryTreeNode* node)
+template <typename TREE, typename NODE, bool ORDER_STATISTICS>
+void AVLTreeLinks<TREE, NODE, ORDER_STATISTICS>::rotateLeft(NODE* node)
 {
-    BinaryTreeNode* parent = node->parent;
-    BinaryTreeNode* nodeleftChild = node->leftChild;
+    AVL_COUNT_STAT(leftRotations);
+    NODE* parent = node->parent;
+    NODE* nodeleftChild = node->leftChild;
 
-    if (parent != root)
+    if (parent != tree().root)
     {
-        BinaryTreeNode* grandparent = parent->parent;
+        NODE* grandparent = parent->parent;
         node->parent = grandparent;
         if (grandparent->leftChild == parent)
         {
@@ -672,7 +2941,7 @@ void BinarySearchTree<TYPE>::rotateLeft(BinaryTreeNode* node)
     }
     else
     {
-        root = node;
+        tree().root = node;
         parent->rightChild = nodeleftChild;
         node->leftChild = parent;
         node->parent = nullptr;
@@ -685,6 +2954,9 @@ void BinarySearchTree<TYPE>::rotateLeft(BinaryTreeNode* node)
 
     parent->treeHeight = getHeight(parent);
     node->treeHeight = getHeight(node);
+    updateSize(parent);
+    updateSize(node);
+    AVL_TOUCH_NODES(2);
 }
 /*
 Get height function calculates and updates the height of a node in the tree using the equation height = maxheight of two subtrees + 1.
@@ -692,11 +2964,11 @@ Get height function calculates and updates the height of a node in the tree usin
 @param[in]: The node needing its height calculated
 @return: The height determined by the node's two subtrees.
 */
-template <typename DATA_TYPE>
-int BinarySearchTree<DATA_TYPE>::getHeight(BinaryTreeNode* node)
+template <typename TREE, typename NODE, bool ORDER_STATISTICS>
+int AVLTreeLinks<TREE, NODE, ORDER_STATISTICS>::getHeight(NODE* node)
 {
-    BinaryTreeNode* right = node->rightChild;
-    BinaryTreeNode* left = node->leftChild;
+    NODE* right = node->rightChild;
+    NODE* left = node->leftChild;
     int leftTreeHeight = 0;
     int rightTreeHeight = 0;
     if (right != nullptr)
@@ -716,4 +2988,4 @@ int BinarySearchTree<DATA_TYPE>::getHeight(BinaryTreeNode* node)
     {
         return (rightTreeHeight + 1);
     }
-}
\ No newline at end of file
+}
\ No newline at end of file
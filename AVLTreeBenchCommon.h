@@ -0,0 +1,51 @@
+/*
+@filename: AVL Search Tree Benchmark Common
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This file contains the helpers shared by the benchmark programs, AVLTreeBenchmark.cpp and AVLTreeBenchSuite.cpp.
+
+Compilation Instructions:
+    Header only. Include from a benchmark program, after or instead of AVLTemplateClass.h.
+*/
+#pragma once
+#include "AVLTemplateClass.h"
+#include <cstddef>
+#include <memory>
+
+/*
+Counting allocator hands out memory through the standard allocator while keeping a running total of the bytes in use, shared by every rebound copy, so the
+benchmarks can report the memory each tree layout and container takes. Allocator overhead inside the heap itself is not counted.
+*/
+inline size_t countedBytes = 0;
+template <typename TYPE>
+struct CountingAllocator
+{
+    using value_type = TYPE;
+
+    CountingAllocator() = default;
+    template <typename OTHER>
+    CountingAllocator(const CountingAllocator<OTHER>&) {}
+
+    TYPE* allocate(size_t count)
+    {
+        countedBytes += count * sizeof(TYPE);
+        return allocator<TYPE>().allocate(count);
+    }
+    void deallocate(TYPE* pointer, size_t count)
+    {
+        countedBytes -= count * sizeof(TYPE);
+        allocator<TYPE>().deallocate(pointer, count);
+    }
+    template <typename OTHER>
+    bool operator==(const CountingAllocator<OTHER>&) const
+    {
+        return true;
+    }
+    template <typename OTHER>
+    bool operator!=(const CountingAllocator<OTHER>&) const
+    {
+        return false;
+    }
+};
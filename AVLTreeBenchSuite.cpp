@@ -0,0 +1,428 @@
+/*
+@filename: AVL Search Tree Benchmark Suite
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This program measures the core operations of the AVL search tree against the standard library's red-black trees, so that the tree's performance
+can be tracked and compared on any platform. BinarySearchTree is compared with std::set and AVLMap with std::map, all holding 64-bit keys.
+
+Every container is run through the same cycle for each key distribution and size:
+  - Insert every key.
+  - Search for keys that are present (hit) and for keys between them (miss).
+  - Traverse all of the keys in order.
+  - Remove half of the keys.
+  - Tear down the container, destroying the other half.
+
+For each operation, the suite reports:
+  - Throughput in millions of operations per second.
+  - The 50th and 99th percentile latency of a sample of single operations.
+  - The bytes allocated per node.
+
+Smaller sizes repeat the cycle until about a million keys have gone through it, so their timings are not lost in the noise.
+
+The distributions decide the order of the keys each operation uses:
+  - sequential: ascending keys.
+  - random: a shuffled order.
+  - zipfian: a shuffled insert order, with searches drawn from a Zipf distribution so a few hot keys take most of them.
+  - zigzag: the adversarial order that alternates between the lowest and highest keys left. Every insert lands on the deepest path in the middle of the tree,
+    and the tree rebalances with double rotations.
+
+Compilation Instructions:
+	Using Ubuntu 22.04:
+		cmake -S . -B build && cmake --build build --target avl_bench && build/avl_bench [maxSize] [--csv]
+		or g++ -std=c++17 -O2 AVLTreeBenchSuite.cpp -o avl_bench -pthread
+	Using Visual Studio:
+		Build in Release configuration and run without the debugger
+	maxSize defaults to 1000000. Sizes go up by factors of ten from 1000, so 100000000 runs the largest trees, which needs around 8 GB of memory.
+*/
+#include "AVLTemplateClass.h"
+#include "AVLMapTemplateClass.h"
+#include "AVLTreeBenchCommon.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+using Clock = chrono::steady_clock;
+using Key = long long;
+
+//One operation in every SAMPLE_STRIDE is timed on its own for the latency percentiles. The rest run untimed, so the clock reads barely affect throughput.
+const size_t SAMPLE_STRIDE = 16;
+//Each size repeats the cycle until at least CYCLE_KEYS keys have gone through it. Searches use one key per key in the tree, up to MAX_LOOKUPS per cycle.
+const size_t CYCLE_KEYS = 1000000;
+const size_t MAX_LOOKUPS = 1 << 22;
+
+using TreeSet = BinarySearchTree<Key, ThreeWayCompare<Key>, CountingAllocator<Key>>;
+using TreeMap = AVLMap<Key, Key, ThreeWayCompare<Key>, CountingAllocator<pair<const Key, Key>>>;
+using StdSet = set<Key, less<Key>, CountingAllocator<Key>>;
+using StdMap = map<Key, Key, less<Key>, CountingAllocator<pair<const Key, Key>>>;
+
+/*
+Container operation functions give the suite one way to insert, search, remove, and traverse each container, so the cycle is written once for all of them.
+
+@param[in]: The container, and the key to use.
+@return: Whether a searched key was found, or the sum of the keys traversed.
+*/
+void insertKey(TreeSet& tree, Key key)
+{
+	tree.tryInsert(key);
+}
+void insertKey(TreeMap& tree, Key key)
+{
+	tree.insert_or_assign(key, key);
+}
+void insertKey(StdSet& tree, Key key)
+{
+	tree.insert(key);
+}
+void insertKey(StdMap& tree, Key key)
+{
+	tree.insert_or_assign(key, key);
+}
+bool findKey(const TreeSet& tree, Key key)
+{
+	return tree.find(key) != nullptr;
+}
+bool findKey(const TreeMap& tree, Key key)
+{
+	return tree.find(key) != nullptr;
+}
+template <typename CONTAINER>
+bool findKey(const CONTAINER& tree, Key key)
+{
+	return tree.find(key) != tree.end();
+}
+void removeKey(TreeSet& tree, Key key)
+{
+	tree.tryRemove(key);
+}
+void removeKey(TreeMap& tree, Key key)
+{
+	tree.tryRemove(key);
+}
+template <typename CONTAINER>
+void removeKey(CONTAINER& tree, Key key)
+{
+	tree.erase(key);
+}
+Key keyOf(Key item)
+{
+	return item;
+}
+Key keyOf(const pair<const Key, Key>& item)
+{
+	return item.first;
+}
+template <typename CONTAINER>
+Key traverseKeys(const CONTAINER& tree)
+{
+	Key sum = 0;
+	for (const auto& item : tree)
+		sum += keyOf(item);
+	return sum;
+}
+
+/*
+Zipf generator draws ranks from 0 to n - 1 where rank r is drawn with probability proportional to 1 / (r + 1)^theta, using the approximation from Gray et al.,
+"Quickly Generating Billion-Record Synthetic Databases", also used by YCSB. Rank 0 is the hottest.
+
+@param[in]: The number of ranks, and the skew theta, below 1.
+@return: A generator returning ranks.
+*/
+class ZipfGenerator
+{
+	size_t rankCount;
+	double theta;
+	double zetaN;
+	double alpha;
+	double eta;
+	double halfPowTheta;
+	uniform_real_distribution<double> uniform;
+
+public:
+	ZipfGenerator(size_t n, double skew) : rankCount(n), theta(skew), zetaN(0), uniform(0.0, 1.0)
+	{
+		for (size_t rank = 1; rank <= n; rank++)
+			zetaN += 1.0 / pow((double)rank, theta);
+		double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+		alpha = 1.0 / (1.0 - theta);
+		eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetaN);
+		halfPowTheta = 1.0 + pow(0.5, theta);
+	}
+	template <typename GENERATOR>
+	size_t operator()(GENERATOR& generator)
+	{
+		double u = uniform(generator);
+		double uz = u * zetaN;
+		if (uz < 1.0)
+			return 0;
+		if (uz < halfPowTheta)
+			return 1;
+		return min(rankCount - 1, (size_t)(rankCount * pow(eta * u - eta + 1.0, alpha)));
+	}
+};
+
+/*
+Key schedule struct holds the keys each operation of the cycle uses, in the order it uses them. The keys are the even numbers below 2n. Misses are the odd
+numbers, one above a key, so they fall between keys throughout the tree rather than off either end.
+*/
+struct KeySchedule
+{
+	vector<Key> insertOrder;
+	vector<Key> hitOrder;
+	vector<Key> removeOrder;
+};
+
+/*
+Make schedule function builds the key schedule of a distribution for a tree of n keys.
+
+@param[in]: The name of the distribution, the number of keys, and the number of searches.
+@return: The key schedule.
+*/
+KeySchedule makeSchedule(const string& distribution, size_t n, size_t lookups)
+{
+	KeySchedule schedule;
+	mt19937_64 generator(n * 31 + distribution.size());
+	schedule.insertOrder.resize(n);
+	for (size_t i = 0; i < n; i++)
+		schedule.insertOrder[i] = (Key)i * 2;
+	schedule.hitOrder.resize(lookups);
+
+	if (distribution == "sequential")
+	{
+		for (size_t i = 0; i < lookups; i++)
+			schedule.hitOrder[i] = (Key)(i % n) * 2;
+		schedule.removeOrder = schedule.insertOrder;
+	}
+	else if (distribution == "zigzag")
+	{
+		for (size_t i = 0; i < n; i++)
+			schedule.insertOrder[i] = (Key)(i % 2 ? n - 1 - i / 2 : i / 2) * 2;
+		for (size_t i = 0; i < lookups; i++)
+			schedule.hitOrder[i] = schedule.insertOrder[i % n];
+		schedule.removeOrder = schedule.insertOrder;
+	}
+	else
+	{
+		shuffle(schedule.insertOrder.begin(), schedule.insertOrder.end(), generator);
+		if (distribution == "zipfian")
+		{
+			//Ranks index the shuffled keys, so the hot keys are scattered across the tree rather than packed together at one end.
+			ZipfGenerator zipf(n, 0.99);
+			for (Key& key : schedule.hitOrder)
+				key = schedule.insertOrder[zipf(generator)];
+		}
+		else
+		{
+			for (Key& key : schedule.hitOrder)
+				key = (Key)(generator() % n) * 2;
+		}
+		schedule.removeOrder = schedule.insertOrder;
+		shuffle(schedule.removeOrder.begin(), schedule.removeOrder.end(), generator);
+	}
+	return schedule;
+}
+
+/*
+Operation result struct accumulates the timings of one operation over the repeats of the cycle.
+*/
+struct OperationResult
+{
+	double seconds = 0;
+	size_t operations = 0;
+	vector<double> sampleNanoseconds;
+};
+
+/*
+Timer overhead function measures the median cost of reading the clock twice, which is subtracted from every latency sample.
+
+@param[in]: Nothing.
+@return: The overhead in nanoseconds.
+*/
+double timerOverhead()
+{
+	vector<double> samples(10001);
+	for (double& sample : samples)
+	{
+		Clock::time_point start = Clock::now();
+		sample = chrono::duration<double, nano>(Clock::now() - start).count();
+	}
+	nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+	return samples[samples.size() / 2];
+}
+
+/*
+Run operation function applies an operation to the keys in order, timing the whole run for throughput and every SAMPLE_STRIDE-th operation on its own for
+latency.
+
+@param[in]: The keys, the operation to apply to each, and the result to add the timings to.
+@return: The number of operations that returned true, so the compiler cannot discard them.
+*/
+template <typename OPERATION>
+size_t runOperation(const Key* keys, size_t count, OPERATION operation, OperationResult& result)
+{
+	size_t hits = 0;
+	Clock::time_point start = Clock::now();
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i % SAMPLE_STRIDE)
+		{
+			hits += operation(keys[i]);
+			continue;
+		}
+		Clock::time_point sampleStart = Clock::now();
+		hits += operation(keys[i]);
+		result.sampleNanoseconds.push_back(chrono::duration<double, nano>(Clock::now() - sampleStart).count());
+	}
+	result.seconds += chrono::duration<double>(Clock::now() - start).count();
+	result.operations += count;
+	return hits;
+}
+
+/*
+Print row function writes one line of results, either as aligned columns or as comma separated values.
+
+@param[in]: The labels of the row, the result, the bytes per node, and whether to write comma separated values.
+@return: Text output of the row.
+*/
+void printRow(const string& container, const string& distribution, size_t size, const string& operation, OperationResult& result, double bytesPerNode, double overhead,
+	bool csv)
+{
+	double throughput = result.seconds > 0 ? result.operations / result.seconds / 1e6 : 0;
+	double p50 = -1;
+	double p99 = -1;
+	if (!result.sampleNanoseconds.empty())
+	{
+		vector<double>& samples = result.sampleNanoseconds;
+		sort(samples.begin(), samples.end());
+		p50 = max(0.0, samples[samples.size() / 2] - overhead);
+		p99 = max(0.0, samples[min(samples.size() - 1, samples.size() * 99 / 100)] - overhead);
+	}
+
+	if (csv)
+	{
+		cout << container << "," << distribution << "," << size << "," << operation << "," << throughput << ",";
+		if (p50 >= 0)
+			cout << p50 << "," << p99;
+		else
+			cout << ",";
+		cout << "," << bytesPerNode << endl;
+		return;
+	}
+	cout << left << setw(18) << container << setw(12) << distribution << right << setw(11) << size << "  " << left << setw(12) << operation << right << fixed;
+	cout << setprecision(2) << setw(10) << throughput;
+	if (p50 >= 0)
+		cout << setprecision(0) << setw(9) << p50 << setw(9) << p99;
+	else
+		cout << setw(9) << "-" << setw(9) << "-";
+	cout << setprecision(1) << setw(12) << bytesPerNode << defaultfloat << endl;
+}
+
+/*
+Benchmark container function runs the cycle on one container for one distribution and size, repeating it for small sizes, and prints a row per operation.
+
+@param[in]: The container type as a template parameter, its label, the distribution and its key schedule, the timer overhead, and whether to write comma
+separated values.
+@return: Text output with the results of each operation.
+*/
+template <typename CONTAINER>
+void benchmarkContainer(const string& label, const string& distribution, const KeySchedule& schedule, double overhead, bool csv)
+{
+	size_t size = schedule.insertOrder.size();
+	size_t lookups = schedule.hitOrder.size();
+	size_t rounds = max((size_t)1, CYCLE_KEYS / size);
+	vector<Key> missOrder(schedule.hitOrder);
+	for (Key& key : missOrder)
+		key++;
+
+	OperationResult insertResult, hitResult, missResult, traverseResult, removeResult, teardownResult;
+	double bytesPerNode = 0;
+	size_t found = 0;
+	for (size_t round = 0; round < rounds; round++)
+	{
+		size_t bytesBefore = countedBytes;
+		unique_ptr<CONTAINER> tree(new CONTAINER());
+		runOperation(schedule.insertOrder.data(), size, [&](Key key) { insertKey(*tree, key); return true; }, insertResult);
+		bytesPerNode = (double)(countedBytes - bytesBefore) / size;
+		found += runOperation(schedule.hitOrder.data(), lookups, [&](Key key) { return findKey(*tree, key); }, hitResult);
+		found += runOperation(missOrder.data(), lookups, [&](Key key) { return findKey(*tree, key); }, missResult);
+
+		Clock::time_point start = Clock::now();
+		Key sum = traverseKeys(*tree);
+		traverseResult.seconds += chrono::duration<double>(Clock::now() - start).count();
+		traverseResult.operations += size;
+		found += sum == (Key)size * ((Key)size - 1);
+
+		runOperation(schedule.removeOrder.data(), size / 2, [&](Key key) { removeKey(*tree, key); return true; }, removeResult);
+		start = Clock::now();
+		tree.reset();
+		teardownResult.seconds += chrono::duration<double>(Clock::now() - start).count();
+		teardownResult.operations += size - size / 2;
+	}
+	if (found != rounds * (lookups + 1))
+		cout << label << " " << distribution << " " << size << ": unexpected search results" << endl;
+
+	printRow(label, distribution, size, "insert", insertResult, bytesPerNode, overhead, csv);
+	printRow(label, distribution, size, "search hit", hitResult, bytesPerNode, overhead, csv);
+	printRow(label, distribution, size, "search miss", missResult, bytesPerNode, overhead, csv);
+	printRow(label, distribution, size, "traverse", traverseResult, bytesPerNode, overhead, csv);
+	printRow(label, distribution, size, "remove", removeResult, bytesPerNode, overhead, csv);
+	printRow(label, distribution, size, "teardown", teardownResult, bytesPerNode, overhead, csv);
+}
+
+/*
+Main function runs every container through every distribution at each size from a thousand keys up to the maximum size.
+
+@param[in]: Optionally the maximum size, and --csv to write comma separated values instead of a table.
+@return: Text output of the results.
+*/
+int main(int argc, char* argv[])
+{
+	size_t maxSize = 1000000;
+	bool csv = false;
+	for (int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		if (argument == "--csv")
+			csv = true;
+		else
+			maxSize = (size_t)strtoull(argv[i], nullptr, 10);
+	}
+	if (maxSize < 1000)
+	{
+		cout << "Usage: avl_bench [maxSize] [--csv], with maxSize of at least 1000" << endl;
+		return 1;
+	}
+
+	double overhead = timerOverhead();
+	if (csv)
+		cout << "container,distribution,size,operation,mops_per_second,p50_ns,p99_ns,bytes_per_node" << endl;
+	else
+	{
+		cout << "Latencies are sampled one operation in " << SAMPLE_STRIDE << ", less the " << overhead << " ns cost of reading the clock" << endl << endl;
+		cout << left << setw(18) << "container" << setw(12) << "distribution" << right << setw(11) << "size" << "  " << left << setw(12) << "operation" << right;
+		cout << setw(10) << "Mops/s" << setw(9) << "p50 ns" << setw(9) << "p99 ns" << setw(12) << "bytes/node" << endl;
+	}
+	for (size_t size = 1000; size <= maxSize; size *= 10)
+	{
+		for (const string distribution : { "sequential", "random", "zipfian", "zigzag" })
+		{
+			KeySchedule schedule = makeSchedule(distribution, size, min(size, MAX_LOOKUPS));
+			benchmarkContainer<TreeSet>("BinarySearchTree", distribution, schedule, overhead, csv);
+			benchmarkContainer<StdSet>("std::set", distribution, schedule, overhead, csv);
+			benchmarkContainer<TreeMap>("AVLMap", distribution, schedule, overhead, csv);
+			benchmarkContainer<StdMap>("std::map", distribution, schedule, overhead, csv);
+		}
+		if (size > maxSize / 10)
+			break;
+	}
+	return 0;
+}
@@ -0,0 +1,946 @@
+/*
+@filename: AVL Search Tree Benchmark Main
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This program measures the performance of the AVL search tree template class. Each benchmark builds trees from generated keys and reports the
+time taken by the operations being compared, so that changes to the tree can be checked against the previous behavior.
+
+Compilation Instructions:
+	Using Ubuntu 22.04:
+		cmake -S . -B build && cmake --build build --target avl_feature_bench
+		or g++ -std=c++17 -O2 AVLTreeBenchmark.cpp -o AVLTreeBenchmark -pthread
+		Add -DAVL_TREE_STATS to also report the nodes touched per operation, and -mavx2 to use the AVX2 snapshot kernels
+	Using Visual Studio:
+		Build in Release configuration and run without the debugger
+*/
+#include "AVLTemplateClass.h"
+#include "AVLCompactTemplateClass.h"
+#include "AVLMultisetTemplateClass.h"
+#include "AVLFrozenTemplateClass.h"
+#include "AVLConcurrentTemplateClass.h"
+#include "AVLPersistentTemplateClass.h"
+#include "AVLShardedTemplateClass.h"
+#include "AVLImageTemplateClass.h"
+#include "AVLIntrusiveTemplateClass.h"
+#include "AVLTreeBenchCommon.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/*
+Compare function used as the function pointer compare policy, matching the compare function used by the test main.
+
+@param[in]: Two TYPE items to be compared.
+@return: -1,0, or 1 based on the comparison of the inputs.
+*/
+template <typename TYPE>
+int compare(const TYPE& item1, const TYPE& item2)
+{
+	if (item1 < item2)
+		return -1;
+	if (item1 == item2)
+		return 0;
+	return 1;
+}
+
+/*
+Elapsed milliseconds function times a single call of the function object passed to it.
+
+@param[in]: The function object to be timed.
+@return: The wall clock time of the call in milliseconds.
+*/
+template <typename FUNCTION>
+double elapsedMilliseconds(FUNCTION function)
+{
+	auto start = chrono::steady_clock::now();
+	function();
+	auto stop = chrono::steady_clock::now();
+	return chrono::duration<double, milli>(stop - start).count();
+}
+
+/*
+Checksum functions reduce a search result to a number that is accumulated by the benchmarks, so the compiler cannot discard the searches.
+
+@param[in]: A value returned from the tree.
+@return: A number derived from the value.
+*/
+size_t checksumOf(int value)
+{
+	return (size_t)value;
+}
+size_t checksumOf(const string& value)
+{
+	return value.size();
+}
+
+/*
+Random keys functions generate a shuffled set of distinct keys of the requested size, using a fixed seed so that each run measures the same workload.
+
+@param[in]: The number of keys to generate.
+@return: A vector of distinct keys in random order.
+*/
+vector<int> randomIntKeys(int size)
+{
+	vector<int> keys(size);
+	for (int i = 0; i < size; i++)
+		keys[i] = i * 2;
+	shuffle(keys.begin(), keys.end(), mt19937(12345));
+	return keys;
+}
+vector<string> randomStringKeys(int size)
+{
+	vector<string> keys;
+	keys.reserve(size);
+	for (int key : randomIntKeys(size))
+		keys.push_back("record-key-" + to_string(key));
+	return keys;
+}
+
+/*
+Compare policy benchmark fills a tree with keys using the given compare policy, then searches every key once.
+
+@param[in]: A label for the output line, the keys to use, and the compare policy instance for the tree.
+@return: Text output with the insert and search times of the policy.
+*/
+template <typename DATA_TYPE, typename Compare>
+void benchmarkComparePolicy(const string& label, const vector<DATA_TYPE>& keys, Compare cmp)
+{
+	BinarySearchTree<DATA_TYPE, Compare> tree(cmp);
+	size_t checksum = 0;
+
+	double insertTime = elapsedMilliseconds([&]() {
+		for (const DATA_TYPE& key : keys)
+			tree.insert(key);
+	});
+	double searchTime = elapsedMilliseconds([&]() {
+		for (const DATA_TYPE& key : keys)
+			checksum += checksumOf(tree.search(key));
+	});
+
+	cout << label << ": insert " << insertTime << " ms, search " << searchTime << " ms (checksum " << checksum << ")" << endl;
+}
+
+/*
+Allocator benchmark builds a tree with the given allocator, then churns it by removing and reinserting every other key, and finally times the destructor.
+
+@param[in]: A label for the output line, the keys to use, and the allocator type as a template parameter.
+@return: Text output with the build, churn, and teardown times of the allocator.
+*/
+template <typename Allocator>
+void benchmarkAllocator(const string& label, const vector<int>& keys)
+{
+	auto tree = make_unique<BinarySearchTree<int, ThreeWayCompare<int>, Allocator>>();
+
+	double buildTime = elapsedMilliseconds([&]() {
+		for (int key : keys)
+			tree->insert(key);
+	});
+	double churnTime = elapsedMilliseconds([&]() {
+		for (int round = 0; round < 4; round++)
+		{
+			for (size_t i = round % 2; i < keys.size(); i += 2)
+				tree->remove(keys[i]);
+			for (size_t i = round % 2; i < keys.size(); i += 2)
+				tree->insert(keys[i]);
+		}
+	});
+	double teardownTime = elapsedMilliseconds([&]() {
+		tree.reset();
+	});
+
+	cout << label << ": build " << buildTime << " ms, churn " << churnTime << " ms, teardown " << teardownTime << " ms" << endl;
+}
+
+/*
+Bulk load benchmark compares building a tree from sorted keys by inserting them one at a time against building it with assignSorted.
+
+@param[in]: The number of sorted keys to load.
+@return: Text output with the time of each way of building the tree.
+*/
+void benchmarkBulkLoad(int keyCount)
+{
+	vector<int> sortedKeys(keyCount);
+	for (int i = 0; i < keyCount; i++)
+		sortedKeys[i] = i;
+
+	BinarySearchTree<int> insertedTree;
+	double insertTime = elapsedMilliseconds([&]() {
+		for (int key : sortedKeys)
+			insertedTree.insert(key);
+	});
+	BinarySearchTree<int> loadedTree;
+	double loadTime = elapsedMilliseconds([&]() {
+		loadedTree.assignSorted(sortedKeys.begin(), sortedKeys.end());
+	});
+
+	cout << "insert loop " << insertTime << " ms, assignSorted " << loadTime << " ms" << endl;
+}
+
+/*
+Miss-heavy benchmark looks up keys that are almost all absent, and inserts keys that are almost all duplicates, once through the throwing search and insert and once
+through find and tryInsert, to show the cost of exceptions on the miss path.
+
+@param[in]: The keys in the tree. Every odd key probed is absent, since the keys are all even.
+@return: Text output with the time of each path.
+*/
+void benchmarkMissPath(const vector<int>& keys)
+{
+	BinarySearchTree<int> tree;
+	for (int key : keys)
+		tree.insert(key);
+	size_t hits = 0;
+
+	double searchTime = elapsedMilliseconds([&]() {
+		for (int key : keys)
+		{
+			try
+			{
+				hits += checksumOf(tree.search(key + 1));
+			}
+			catch (ItemNotFoundException&)
+			{
+			}
+		}
+	});
+	double findTime = elapsedMilliseconds([&]() {
+		for (int key : keys)
+			hits += tree.find(key + 1) != nullptr;
+	});
+	double insertTime = elapsedMilliseconds([&]() {
+		for (int key : keys)
+		{
+			try
+			{
+				tree.insert(key);
+			}
+			catch (DuplicateItemException&)
+			{
+			}
+		}
+	});
+	double tryInsertTime = elapsedMilliseconds([&]() {
+		for (int key : keys)
+			hits += tree.tryInsert(key).second;
+	});
+
+	cout << "search " << searchTime << " ms, find " << findTime << " ms" << endl;
+	cout << "insert " << insertTime << " ms, tryInsert " << tryInsertTime << " ms (hits " << hits << ")" << endl;
+}
+
+/*
+Teardown benchmark times emptying a large tree, through clear on a tree that is then reused, and through the destructor, for the given allocator.
+
+@param[in]: A label for the output line, the number of nodes, and the allocator type as a template parameter.
+@return: Text output with the clear and destructor times.
+*/
+template <typename Allocator>
+void benchmarkTeardown(const string& label, int nodeCount)
+{
+	vector<int> sortedKeys(nodeCount);
+	for (int i = 0; i < nodeCount; i++)
+		sortedKeys[i] = i;
+
+	auto tree = make_unique<BinarySearchTree<int, ThreeWayCompare<int>, Allocator>>();
+	tree->assignSorted(sortedKeys.begin(), sortedKeys.end());
+	double clearTime = elapsedMilliseconds([&]() {
+		tree->clear();
+	});
+	tree->assignSorted(sortedKeys.begin(), sortedKeys.end());
+	double destructorTime = elapsedMilliseconds([&]() {
+		tree.reset();
+	});
+
+	cout << label << ": clear " << clearTime << " ms, destructor " << destructorTime << " ms" << endl;
+}
+
+/*
+Delete-heavy benchmark builds a tree and then removes most of its keys, reinserting a quarter of them between rounds, to time the remove path. When built with
+AVL_TREE_STATS defined it also reports the nodes touched, comparisons, rebalances, and rotations per operation, and the depth of the descents.
+
+@param[in]: The keys to use.
+@return: Text output with the remove time, and the instrumentation counts when counted.
+*/
+void benchmarkDeleteHeavy(const vector<int>& keys)
+{
+	BinarySearchTree<int> tree;
+	for (int key : keys)
+		tree.insert(key);
+#ifdef AVL_TREE_STATS
+	tree.resetStats();
+#endif
+	long long operations = 0;
+
+	double removeTime = elapsedMilliseconds([&]() {
+		for (int round = 0; round < 4; round++)
+		{
+			for (size_t i = round; i < keys.size(); i += 4)
+				tree.remove(keys[i]);
+			operations += (long long)(keys.size() - round + 3) / 4;
+		}
+		for (size_t i = 0; i < keys.size(); i += 4)
+			tree.insert(keys[i]);
+		for (size_t i = 0; i < keys.size(); i += 4)
+			tree.remove(keys[i]);
+		operations += 2 * (long long)((keys.size() + 3) / 4);
+	});
+
+	cout << "remove-heavy workload " << removeTime << " ms for " << operations << " operations" << endl;
+#ifdef AVL_TREE_STATS
+	TreeStats stats = tree.stats();
+	cout << "per operation: nodes touched " << (double)stats.nodesTouched / operations << ", comparisons " << (double)stats.comparisons / operations;
+	cout << ", rebalances " << (double)(stats.insertRebalances + stats.removeRebalances) / operations << ", rotations ";
+	cout << (double)(stats.leftRotations + stats.rightRotations) / operations << endl;
+	cout << "descent depth: mean " << stats.averageDescentDepth() << ", p50 " << stats.descentDepthPercentile(0.5) << ", p99 " << stats.descentDepthPercentile(0.99) << endl;
+#endif
+}
+
+/*
+Layout benchmark builds the pointer tree and the compact tree from the same keys, reporting the bytes each takes per node, as counted by the allocator, and the
+time of a random lookup. The compact tree is measured as grown by inserts, so its figure includes the spare capacity of the node vector.
+
+@param[in]: A label for the output line, the keys to use, and the tree type as a template parameter.
+@return: Text output with the memory per node and the lookup latency.
+*/
+template <typename TREE>
+void benchmarkLayout(const string& label, const vector<int>& keys)
+{
+	size_t startBytes = countedBytes;
+	TREE tree;
+	for (int key : keys)
+		tree.insert(key);
+	double bytesPerNode = (double)(countedBytes - startBytes) / keys.size();
+
+	vector<int> probes = keys;
+	shuffle(probes.begin(), probes.end(), mt19937(54321));
+	size_t checksum = 0;
+	double searchTime = elapsedMilliseconds([&]() {
+		for (int key : probes)
+			checksum += checksumOf(*tree.find(key));
+	});
+
+	cout << label << ": " << bytesPerNode << " bytes per node, lookup " << searchTime * 1000000.0 / probes.size() << " ns (checksum " << checksum << ")" << endl;
+}
+
+/*
+Snapshot benchmark times random lookups of every key in a tree and in a frozen snapshot of it.
+
+@param[in]: A label for the output line, and the keys to use.
+@return: Text output with the lookup latency of the tree and the snapshot.
+*/
+template <typename DATA_TYPE>
+void benchmarkSnapshot(const string& label, const vector<DATA_TYPE>& keys)
+{
+	BinarySearchTree<DATA_TYPE> tree;
+	for (const DATA_TYPE& key : keys)
+		tree.insert(key);
+	FrozenSearchTree<DATA_TYPE> snapshot = tree.freeze();
+
+	vector<DATA_TYPE> probes = keys;
+	shuffle(probes.begin(), probes.end(), mt19937(54321));
+	size_t treeHits = 0;
+	size_t snapshotHits = 0;
+	double treeTime = elapsedMilliseconds([&]() {
+		for (const DATA_TYPE& key : probes)
+			treeHits += tree.find(key) != nullptr;
+	});
+	double snapshotTime = elapsedMilliseconds([&]() {
+		for (const DATA_TYPE& key : probes)
+			snapshotHits += snapshot.contains(key);
+	});
+
+	cout << label << ": tree " << treeTime * 1000000.0 / probes.size() << " ns, snapshot " << snapshotTime * 1000000.0 / probes.size() << " ns per lookup";
+	cout << (FrozenSearchTree<DATA_TYPE>::BLOCKED ? " (blocked layout)" : " (Eytzinger layout)") << " (hits " << treeHits << ", " << snapshotHits << ")" << endl;
+}
+
+/*
+Batch search benchmark builds a tree far larger than the last level cache by inserting keys in random order, then looks up a random half present, half absent
+set of keys, once with a loop of single find calls and once with searchBatch in batches of a few hundred keys.
+
+@param[in]: The number of keys in the tree.
+@return: Text output with the lookup latency of each way.
+*/
+void benchmarkSearchBatch(int treeKeyCount)
+{
+	vector<int> keys = randomIntKeys(treeKeyCount);
+	BinarySearchTree<int, ThreeWayCompare<int>, PoolAllocator<int>> tree;
+	for (int key : keys)
+		tree.insert(key);
+
+	const size_t batchSize = 256;
+	vector<int> probes(keys.begin(), keys.begin() + min<size_t>(keys.size(), 2000000));
+	for (size_t i = 1; i < probes.size(); i += 2)
+		probes[i]++;
+	size_t singleHits = 0;
+	size_t batchHits = 0;
+
+	double singleTime = elapsedMilliseconds([&]() {
+		for (int key : probes)
+			singleHits += tree.find(key) != nullptr;
+	});
+	double batchTime = elapsedMilliseconds([&]() {
+		vector<int> batch;
+		vector<const int*> results;
+		for (size_t start = 0; start < probes.size(); start += batchSize)
+		{
+			batch.assign(probes.begin() + start, probes.begin() + min(probes.size(), start + batchSize));
+			tree.searchBatch(batch, results);
+			for (const int* result : results)
+				batchHits += result != nullptr;
+		}
+	});
+
+	cout << "find loop " << singleTime * 1000000.0 / probes.size() << " ns, searchBatch " << batchTime * 1000000.0 / probes.size() << " ns per key";
+	cout << " (hits " << singleHits << ", " << batchHits << ")" << endl;
+}
+
+/*
+Run threads function starts a number of threads that each call the operation a fixed number of times, and times how long they take together. The results of
+the operations are summed into a shared checksum, so the compiler cannot discard them.
+
+@param[in]: The number of threads, the operations per thread, and the operation, called with the thread number and the operation number.
+@return: The wall clock time in milliseconds until every thread finished.
+*/
+atomic<size_t> threadChecksum{ 0 };
+template <typename OPERATION>
+double runThreads(int threadCount, int operationsPerThread, OPERATION operation)
+{
+	return elapsedMilliseconds([&]() {
+		vector<thread> threads;
+		for (int t = 0; t < threadCount; t++)
+		{
+			threads.emplace_back([&operation, operationsPerThread, t]() {
+				size_t checksum = 0;
+				for (int i = 0; i < operationsPerThread; i++)
+					checksum += operation(t, i);
+				threadChecksum += checksum;
+			});
+		}
+		for (thread& worker : threads)
+			worker.join();
+	});
+}
+
+/*
+Concurrency scaling benchmark runs a read-mostly workload, one write in ten operations, on 1 to N threads against three trees: a BinarySearchTree behind
+one global mutex, a ConcurrentBinarySearchTree with plain shared_mutex locking, and a ConcurrentBinarySearchTree with optimistic reads.
+
+@param[in]: The keys to preload, and the operations each thread runs.
+@return: Text output with the throughput of each tree at each thread count.
+*/
+void benchmarkConcurrency(const vector<int>& keys, int operationsPerThread)
+{
+	BinarySearchTree<int> mutexTree;
+	mutex treeMutex;
+	ConcurrentBinarySearchTree<int> lockedTree(ThreeWayCompare<int>(), false);
+	ConcurrentBinarySearchTree<int> optimisticTree;
+	for (int key : keys)
+	{
+		mutexTree.insert(key);
+		lockedTree.insert(key);
+		optimisticTree.insert(key);
+	}
+
+	//Keys are all even, so written keys are odd and never disturb the preloaded ones.
+	auto keyFor = [&keys](int t, int i) { return keys[((size_t)i * 7919 + (size_t)t * 104729) % keys.size()]; };
+	int maxThreads = max(4, (int)thread::hardware_concurrency());
+	for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+	{
+		double mutexTime = runThreads(threadCount, operationsPerThread, [&](int t, int i) {
+			int key = keyFor(t, i);
+			lock_guard<mutex> lock(treeMutex);
+			if (i % 20 == 0)
+				return mutexTree.tryInsert(key + 1).second;
+			if (i % 20 == 10)
+				return mutexTree.tryRemove(key + 1);
+			return mutexTree.find(key) != nullptr;
+		});
+		auto concurrentOperation = [&](ConcurrentBinarySearchTree<int>& tree) {
+			return [&](int t, int i) {
+				int key = keyFor(t, i);
+				if (i % 20 == 0)
+					return tree.tryInsert(key + 1);
+				if (i % 20 == 10)
+					return tree.tryRemove(key + 1);
+				return tree.contains(key);
+			};
+		};
+		double lockedTime = runThreads(threadCount, operationsPerThread, concurrentOperation(lockedTree));
+		double optimisticTime = runThreads(threadCount, operationsPerThread, concurrentOperation(optimisticTree));
+
+		double operations = (double)threadCount * operationsPerThread / 1000.0;
+		cout << threadCount << " threads: global mutex " << operations / mutexTime << " Mops/s, shared_mutex " << operations / lockedTime;
+		cout << " Mops/s, optimistic " << operations / optimisticTime << " Mops/s" << endl;
+	}
+}
+
+/*
+Persistent version benchmark compares the write cost of path copying with the mutable tree, and reports the nodes and bytes each write copies. It then runs one
+writer against one thread scanning the whole tree over and over, once with a ConcurrentBinarySearchTree, whose scans hold the shared lock, and once with a
+PersistentBinarySearchTree, whose scans read a snapshot without blocking the writer.
+
+@param[in]: The keys to preload, and the number of writes to time.
+@return: Text output with the write times, copies per write, and the writer throughput while scans run.
+*/
+void benchmarkPersistent(const vector<int>& keys, int writeCount)
+{
+	BinarySearchTree<int> mutableTree;
+	PersistentBinarySearchTree<int> persistentTree;
+	ConcurrentBinarySearchTree<int> concurrentTree;
+	for (int key : keys)
+	{
+		mutableTree.insert(key);
+		persistentTree.insert(key);
+		concurrentTree.insert(key);
+	}
+
+	//Keys are all even, so written keys are odd and never disturb the preloaded ones.
+	auto writeKey = [&keys](int i) { return keys[((size_t)i * 7919) % keys.size()] + 1; };
+	double mutableTime = elapsedMilliseconds([&]() {
+		for (int i = 0; i < writeCount; i++)
+			i % 2 ? mutableTree.tryRemove(writeKey(i - 1)) : (bool)mutableTree.tryInsert(writeKey(i)).second;
+	});
+	PersistentBinarySearchTree<int>::WriteStats before = persistentTree.totalWriteStats();
+	double persistentTime = elapsedMilliseconds([&]() {
+		for (int i = 0; i < writeCount; i++)
+			i % 2 ? persistentTree.tryRemove(writeKey(i - 1)) : persistentTree.tryInsert(writeKey(i));
+	});
+	PersistentBinarySearchTree<int>::WriteStats after = persistentTree.totalWriteStats();
+	double writes = (double)(after.writes - before.writes);
+	cout << "mutable tree " << mutableTime * 1000.0 / writeCount << " us per write" << endl;
+	cout << "persistent tree " << persistentTime * 1000.0 / writeCount << " us per write, " << (after.nodesCopied - before.nodesCopied) / writes;
+	cout << " nodes and " << (after.bytesCopied - before.bytesCopied) / writes << " bytes copied per write" << endl;
+
+	auto scanWhileWriting = [&](auto write, auto scan) {
+		atomic<bool> writing{ true };
+		size_t scans = 0;
+		thread scanner([&]() {
+			while (writing)
+			{
+				threadChecksum += scan();
+				scans++;
+			}
+		});
+		double time = elapsedMilliseconds([&]() {
+			for (int i = 0; i < writeCount; i++)
+				write(i);
+		});
+		writing = false;
+		scanner.join();
+		cout << writeCount * 1.0 / time << " writes/ms with " << scans << " full scans" << endl;
+	};
+	cout << "concurrent tree, locked scans: ";
+	scanWhileWriting([&](int i) { i % 2 ? concurrentTree.tryRemove(writeKey(i - 1)) : concurrentTree.tryInsert(writeKey(i)); }, [&]() {
+		size_t sum = 0;
+		concurrentTree.forEachInRange(INT_MIN, INT_MAX, [&sum](int value) { sum += value; });
+		return sum;
+	});
+	cout << "persistent tree, snapshot scans: ";
+	scanWhileWriting([&](int i) { i % 2 ? persistentTree.tryRemove(writeKey(i - 1)) : persistentTree.tryInsert(writeKey(i)); }, [&]() {
+		size_t sum = 0;
+		persistentTree.snapshot().inOrder([&sum](int value) { sum += value; });
+		return sum;
+	});
+}
+
+/*
+Sharded throughput benchmark runs a write-heavy workload, half inserts and removes, on 1 to N threads against a ConcurrentBinarySearchTree, whose writers all
+take one lock, and a ShardedAVL with one shard per thread at the largest thread count.
+
+@param[in]: The keys to preload, and the operations each thread runs.
+@return: Text output with the throughput of each container at each thread count.
+*/
+void benchmarkSharded(const vector<int>& keys, int operationsPerThread)
+{
+	int maxThreads = max(4, (int)thread::hardware_concurrency());
+	ConcurrentBinarySearchTree<int> singleTree(ThreeWayCompare<int>(), false);
+	ShardedAVL<int> shardedTree(maxThreads);
+	for (int key : keys)
+	{
+		singleTree.insert(key);
+		shardedTree.insert(key);
+	}
+	cout << "shard sizes after loading:";
+	for (int size : shardedTree.shardSizes())
+		cout << " " << size;
+	cout << " (" << shardedTree.rebalanceCount() << " rebalances)" << endl;
+
+	//Keys are all even, so written keys are odd and never disturb the preloaded ones.
+	auto keyFor = [&keys](int t, int i) { return keys[((size_t)i * 7919 + (size_t)t * 104729) % keys.size()]; };
+	auto writeHeavy = [&keyFor](auto& tree) {
+		return [&tree, &keyFor](int t, int i) {
+			int key = keyFor(t, i / 4);
+			switch (i % 4)
+			{
+			case 0:
+				return tree.tryInsert(key + 1);
+			case 2:
+				return tree.tryRemove(key + 1);
+			default:
+				return tree.contains(key);
+			}
+		};
+	};
+	for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+	{
+		double singleTime = runThreads(threadCount, operationsPerThread, writeHeavy(singleTree));
+		double shardedTime = runThreads(threadCount, operationsPerThread, writeHeavy(shardedTree));
+		double operations = (double)threadCount * operationsPerThread / 1000.0;
+		cout << threadCount << " threads: single tree " << operations / singleTime << " Mops/s, sharded " << operations / shardedTime << " Mops/s" << endl;
+	}
+}
+
+/*
+Set operation benchmark merges a second tree into a tree of the keys, once by inserting each value and once with unionWith, for a second tree as large as the
+first and for one a thousand times smaller. It then times intersectWith and differenceWith on the two large trees.
+
+@param[in]: The keys of the first tree.
+@return: Text output with the time of each merge and operation.
+*/
+void benchmarkSetOperations(const vector<int>& keys)
+{
+	mt19937 generator(7);
+	for (size_t otherCount : { keys.size(), keys.size() / 1000 })
+	{
+		//Other values are drawn from twice the key range, so about half of them are already present.
+		vector<int> otherKeys;
+		for (size_t i = 0; i < otherCount; i++)
+			otherKeys.push_back(keys[generator() % keys.size()] + (int)(generator() % 2));
+		BinarySearchTree<int> insertTree(keys.begin(), keys.end(), true);
+		BinarySearchTree<int> unionTree(keys.begin(), keys.end(), true);
+		BinarySearchTree<int> insertSource(otherKeys.begin(), otherKeys.end(), true);
+		BinarySearchTree<int> unionSource(otherKeys.begin(), otherKeys.end(), true);
+
+		double insertTime = elapsedMilliseconds([&]() {
+			for (int value : insertSource)
+				insertTree.tryInsert(value);
+		});
+		double unionTime = elapsedMilliseconds([&]() { unionTree.unionWith(unionSource); });
+		cout << "merge " << insertSource.count() << " values: insert loop " << insertTime << " ms, unionWith " << unionTime << " ms";
+		cout << (insertTree.count() == unionTree.count() ? "" : " (counts differ)") << endl;
+	}
+
+	vector<int> otherKeys;
+	for (size_t i = 0; i < keys.size(); i++)
+		otherKeys.push_back(keys[generator() % keys.size()] + (int)(generator() % 2));
+	BinarySearchTree<int> intersectTree(keys.begin(), keys.end(), true);
+	BinarySearchTree<int> intersectSource(otherKeys.begin(), otherKeys.end(), true);
+	BinarySearchTree<int> differenceTree(keys.begin(), keys.end(), true);
+	BinarySearchTree<int> differenceSource(otherKeys.begin(), otherKeys.end(), true);
+	double intersectTime = elapsedMilliseconds([&]() { intersectTree.intersectWith(intersectSource); });
+	double differenceTime = elapsedMilliseconds([&]() { differenceTree.differenceWith(differenceSource); });
+	cout << "intersectWith " << intersectTime << " ms (" << intersectTree.count() << " left), differenceWith " << differenceTime << " ms (";
+	cout << differenceTree.count() << " left)" << endl;
+}
+
+/*
+Batch update benchmark applies sorted batches of 10 thousand to 1 million new keys to a tree built by inserting the keys, once with a loop of tryInsert and
+tryRemove and once with insertBatch and removeBatch, which are asked to run in parallel since the int compare is safe to call from several threads.
+
+@param[in]: The keys of the tree.
+@return: Text output with the time of each way of applying each batch.
+*/
+void benchmarkBatchUpdate(const vector<int>& keys)
+{
+	mt19937 generator(11);
+	for (size_t batchSize : { (size_t)10000, (size_t)100000, (size_t)1000000 })
+	{
+		//Keys are all even, so batch keys are odd, and about one in a hundred repeats to exercise the duplicate reporting.
+		vector<int> batch;
+		for (size_t i = 0; i < batchSize; i++)
+			batch.push_back(keys[generator() % keys.size()] + (generator() % 100 ? 1 : 0));
+		sort(batch.begin(), batch.end());
+		BinarySearchTree<int> loopTree;
+		BinarySearchTree<int> batchTree;
+		for (int key : keys)
+		{
+			loopTree.insert(key);
+			batchTree.insert(key);
+		}
+
+		double loopInsertTime = elapsedMilliseconds([&]() {
+			for (int key : batch)
+				loopTree.tryInsert(key);
+		});
+		vector<int> duplicates;
+		double batchInsertTime = elapsedMilliseconds([&]() { batchTree.insertBatch(batch.begin(), batch.end(), &duplicates, true); });
+		double loopRemoveTime = elapsedMilliseconds([&]() {
+			for (int key : batch)
+				loopTree.tryRemove(key);
+		});
+		vector<int> notFound;
+		double batchRemoveTime = elapsedMilliseconds([&]() { batchTree.removeBatch(batch.begin(), batch.end(), &notFound, true); });
+
+		cout << batchSize << " keys: insert loop " << loopInsertTime << " ms, insertBatch " << batchInsertTime << " ms (" << duplicates.size();
+		cout << " duplicates); remove loop " << loopRemoveTime << " ms, removeBatch " << batchRemoveTime << " ms (" << notFound.size() << " not found)";
+		cout << (loopTree.count() == batchTree.count() ? "" : " (counts differ)") << endl;
+	}
+}
+
+/*
+Repeated key benchmark inserts many copies of a few thousand keys, once into a tree of keys salted with a sequence number to keep them distinct and once into
+an AVLMultiset, then counts the copies of each key and removes one copy of each.
+
+@param[in]: The number of inserts, and the number of distinct keys they are spread over.
+@return: Text output with the time and memory of each way of holding the repeated keys.
+*/
+void benchmarkRepeatedKeys(int insertCount, int distinctKeys)
+{
+	mt19937 generator(21);
+	vector<int> events(insertCount);
+	for (int& event : events)
+		event = (int)(generator() % distinctKeys) * 2;
+
+	using SaltedKey = pair<int, int>;
+	size_t bytesBefore = countedBytes;
+	BinarySearchTree<SaltedKey, ThreeWayCompare<SaltedKey>, CountingAllocator<SaltedKey>> saltedTree;
+	double saltedInsertTime = elapsedMilliseconds([&]() {
+		for (int i = 0; i < insertCount; i++)
+			saltedTree.insert(SaltedKey(events[i], i));
+	});
+	size_t saltedBytes = countedBytes - bytesBefore;
+	long long saltedTotal = 0;
+	double saltedCountTime = elapsedMilliseconds([&]() {
+		for (int key = 0; key < distinctKeys * 2; key += 2)
+		{
+			auto last = saltedTree.lowerBound(SaltedKey(key + 1, INT_MIN));
+			for (auto current = saltedTree.lowerBound(SaltedKey(key, INT_MIN)); current != last; ++current)
+				saltedTotal++;
+		}
+	});
+	double saltedEraseTime = elapsedMilliseconds([&]() {
+		for (int key = 0; key < distinctKeys * 2; key += 2)
+		{
+			auto first = saltedTree.lowerBound(SaltedKey(key, INT_MIN));
+			if (first != saltedTree.end() && first->first == key)
+				saltedTree.remove(*first);
+		}
+	});
+
+	bytesBefore = countedBytes;
+	AVLMultiset<int, ThreeWayCompare<int>, CountingAllocator<MultisetEntry<int>>> multiset;
+	double multisetInsertTime = elapsedMilliseconds([&]() {
+		for (int event : events)
+			multiset.insert(event);
+	});
+	size_t multisetBytes = countedBytes - bytesBefore;
+	long long multisetTotal = 0;
+	double multisetCountTime = elapsedMilliseconds([&]() {
+		for (int key = 0; key < distinctKeys * 2; key += 2)
+			multisetTotal += multiset.count(key);
+	});
+	double multisetEraseTime = elapsedMilliseconds([&]() {
+		for (int key = 0; key < distinctKeys * 2; key += 2)
+			multiset.eraseOne(key);
+	});
+
+	cout << "salted keys: insert " << saltedInsertTime << " ms, count " << saltedCountTime << " ms, erase one " << saltedEraseTime << " ms, ";
+	cout << saltedBytes / (1024 * 1024) << " MB" << endl;
+	cout << "AVLMultiset: insert " << multisetInsertTime << " ms, count " << multisetCountTime << " ms, erase one " << multisetEraseTime << " ms, ";
+	cout << multisetBytes / 1024 << " KB" << (saltedTotal == multisetTotal && saltedTree.count() == multiset.totalCount() ? "" : " (counts differ)") << endl;
+}
+
+/*
+Slab record struct is a record owned by a slab, a vector of records, and indexed by key. It embeds a hook for the intrusive tree and carries a payload, so
+copying it into a node costs as much as a real record would.
+*/
+struct SlabRecord : AVLHook<>
+{
+	int key = 0;
+	char payload[56] = {};
+
+	bool operator<(const SlabRecord& other) const
+	{
+		return key < other.key;
+	}
+};
+
+/*
+Intrusive benchmark indexes records held in a slab, once by copying each record into a BinarySearchTree node and once by linking the records in place into an
+IntrusiveAVLTree, then looks up and removes every record through each index.
+
+@param[in]: The keys of the records.
+@return: Text output with the time of each operation and the memory each index allocated.
+*/
+void benchmarkIntrusive(const vector<int>& keys)
+{
+	vector<SlabRecord> slab(keys.size());
+	for (size_t i = 0; i < keys.size(); i++)
+		slab[i].key = keys[i];
+
+	size_t bytesBefore = countedBytes;
+	BinarySearchTree<SlabRecord, ThreeWayCompare<SlabRecord>, CountingAllocator<SlabRecord>> copyTree;
+	double copyInsertTime = elapsedMilliseconds([&]() {
+		for (const SlabRecord& record : slab)
+			copyTree.tryInsert(record);
+	});
+	size_t copyBytes = countedBytes - bytesBefore;
+	size_t copyFound = 0;
+	double copySearchTime = elapsedMilliseconds([&]() {
+		for (const SlabRecord& record : slab)
+			copyFound += copyTree.find(record) != nullptr;
+	});
+	double copyRemoveTime = elapsedMilliseconds([&]() {
+		for (const SlabRecord& record : slab)
+			copyTree.tryRemove(record);
+	});
+
+	IntrusiveAVLTree<SlabRecord> intrusiveTree;
+	double intrusiveInsertTime = elapsedMilliseconds([&]() {
+		for (SlabRecord& record : slab)
+			if (!record.isLinked())
+				intrusiveTree.tryInsert(record);
+	});
+	size_t intrusiveCount = intrusiveTree.count();
+	size_t intrusiveFound = 0;
+	double intrusiveSearchTime = elapsedMilliseconds([&]() {
+		for (const SlabRecord& record : slab)
+			intrusiveFound += intrusiveTree.find(record) != nullptr;
+	});
+	double intrusiveRemoveTime = elapsedMilliseconds([&]() {
+		for (SlabRecord& record : slab)
+			if (record.isLinked())
+				intrusiveTree.remove(record);
+	});
+
+	cout << "BinarySearchTree copies: insert " << copyInsertTime << " ms, find " << copySearchTime << " ms, remove " << copyRemoveTime << " ms, ";
+	cout << copyBytes / (1024 * 1024) << " MB allocated" << endl;
+	cout << "IntrusiveAVLTree: insert " << intrusiveInsertTime << " ms, find " << intrusiveSearchTime << " ms, remove " << intrusiveRemoveTime << " ms, ";
+	cout << "0 MB allocated, " << sizeof(AVLHook<>) << " byte hook per record" << (copyFound == intrusiveFound && intrusiveFound == intrusiveCount ? "" : " (counts differ)") << endl;
+}
+
+/*
+Startup benchmark compares the ways of getting a tree of the keys ready to serve lookups when a process starts: inserting the keys one at a time, loading an
+image saved by an earlier run, and mapping that image. The lookups after each are timed as well, since the mapped image is read in as they touch it.
+
+@param[in]: The keys of the tree.
+@return: Text output with the time to get the tree ready and to look up every key in it.
+*/
+void benchmarkStartup(const vector<int>& keys)
+{
+	const string imagePath = "AVLTreeBenchmarkImage.bin";
+	BinarySearchTree<int> insertTree;
+	double insertTime = elapsedMilliseconds([&]() {
+		for (int key : keys)
+			insertTree.tryInsert(key);
+	});
+	double saveTime = elapsedMilliseconds([&]() { insertTree.save(imagePath); });
+	BinarySearchTree<int> loadTree;
+	double loadTime = elapsedMilliseconds([&]() { loadTree.load(imagePath); });
+	unique_ptr<MappedSearchTree<int>> mappedTree;
+	double mapTime = elapsedMilliseconds([&]() { mappedTree.reset(new MappedSearchTree<int>(imagePath)); });
+
+	int found = 0;
+	double loadLookupTime = elapsedMilliseconds([&]() {
+		for (int key : keys)
+			found += loadTree.find(key) != nullptr;
+	});
+	double mapLookupTime = elapsedMilliseconds([&]() {
+		for (int key : keys)
+			found += mappedTree->contains(key);
+	});
+	mappedTree.reset();
+	remove(imagePath.c_str());
+
+	cout << "insert rebuild " << insertTime << " ms, save " << saveTime << " ms, load " << loadTime << " ms, map " << mapTime << " ms" << endl;
+	cout << "lookups after load " << loadLookupTime << " ms, lookups in mapping " << mapLookupTime << " ms";
+	cout << (found == 2 * insertTree.count() ? "" : " (lookups missed)") << endl;
+}
+
+/*
+Main function runs each benchmark in turn over a fixed number of keys.
+
+@param[in]: Nothing. Main creates the trees itself.
+@return: Text output of the benchmark timings.
+*/
+int main()
+{
+	const int keyCount = 1000000;
+
+	cout << "Compare policy benchmark (" << keyCount << " keys)" << endl;
+	vector<int> intKeys = randomIntKeys(keyCount);
+	benchmarkComparePolicy("int, function pointer", intKeys, CompareFunction<int>(compare<int>));
+	benchmarkComparePolicy("int, ThreeWayCompare", intKeys, ThreeWayCompare<int>());
+	vector<string> stringKeys = randomStringKeys(keyCount);
+	benchmarkComparePolicy("string, function pointer", stringKeys, CompareFunction<string>(compare<string>));
+	benchmarkComparePolicy("string, ThreeWayCompare", stringKeys, ThreeWayCompare<string>());
+	cout << endl;
+
+	cout << "Allocator benchmark (" << keyCount << " keys)" << endl;
+	benchmarkAllocator<allocator<int>>("allocator", intKeys);
+	benchmarkAllocator<PoolAllocator<int>>("PoolAllocator", intKeys);
+	cout << endl;
+
+	cout << "Miss path benchmark (" << keyCount << " keys)" << endl;
+	benchmarkMissPath(intKeys);
+	cout << endl;
+
+	cout << "Node layout benchmark (" << keyCount << " keys)" << endl;
+	benchmarkLayout<BinarySearchTree<int, ThreeWayCompare<int>, CountingAllocator<int>>>("pointer nodes", intKeys);
+	benchmarkLayout<CompactBinarySearchTree<int, ThreeWayCompare<int>, CountingAllocator<int>>>("compact nodes", intKeys);
+	cout << endl;
+
+	cout << "Frozen snapshot benchmark (" << keyCount << " keys)" << endl;
+	benchmarkSnapshot("int", intKeys);
+	benchmarkSnapshot("string", stringKeys);
+	cout << endl;
+
+	const int batchTreeCount = 6000000;
+	cout << "Batch search benchmark (" << batchTreeCount << " keys)" << endl;
+	benchmarkSearchBatch(batchTreeCount);
+	cout << endl;
+
+	cout << "Concurrency scaling benchmark (" << keyCount << " keys, " << thread::hardware_concurrency() << " hardware threads)" << endl;
+	benchmarkConcurrency(intKeys, 200000);
+	cout << endl;
+
+	cout << "Sharded throughput benchmark (" << keyCount << " keys, " << thread::hardware_concurrency() << " hardware threads)" << endl;
+	benchmarkSharded(intKeys, 200000);
+	cout << endl;
+
+	cout << "Persistent version benchmark (" << keyCount << " keys)" << endl;
+	benchmarkPersistent(intKeys, 200000);
+	cout << endl;
+
+	cout << "Set operation benchmark (" << keyCount << " keys)" << endl;
+	benchmarkSetOperations(intKeys);
+	cout << endl;
+
+	cout << "Batch update benchmark (" << keyCount << " keys)" << endl;
+	benchmarkBatchUpdate(intKeys);
+	cout << endl;
+
+	cout << "Repeated key benchmark (" << keyCount << " inserts of 2000 keys)" << endl;
+	benchmarkRepeatedKeys(keyCount, 2000);
+	cout << endl;
+
+	cout << "Intrusive index benchmark (" << keyCount << " records)" << endl;
+	benchmarkIntrusive(intKeys);
+	cout << endl;
+
+	cout << "Startup benchmark (" << keyCount << " keys)" << endl;
+	benchmarkStartup(intKeys);
+	cout << endl;
+
+	cout << "Delete-heavy benchmark (" << keyCount << " keys)" << endl;
+	benchmarkDeleteHeavy(intKeys);
+	cout << endl;
+
+	const int teardownCount = 10000000;
+	cout << "Teardown benchmark (" << teardownCount << " nodes)" << endl;
+	benchmarkTeardown<allocator<int>>("allocator", teardownCount);
+	benchmarkTeardown<PoolAllocator<int>>("PoolAllocator", teardownCount);
+	cout << endl;
+
+	cout << "Bulk load benchmark (" << keyCount << " sorted keys)" << endl;
+	benchmarkBulkLoad(keyCount);
+	cout << endl;
+
+	return 0;
+}
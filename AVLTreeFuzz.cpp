@@ -0,0 +1,371 @@
+/*
+@filename: AVL Search Tree Differential Fuzz Driver
+
+@author: Doc Holloway
+@date: 10/16/2026
+
+@description: This program checks the AVL search tree against std::set over long runs of random mixed operations. It reads a run of operations from bytes and
+applies each one to a plain tree, to an order statistic tree on a PoolAllocator, to an intrusive tree over a fixed set of records, and to a std::set, stopping with an error at the first difference in results.
+After every operation it calls validate() on every tree, so a slip in the rebalancing or rotation code shows up at the operation that caused it, not later when
+a search happens to go wrong. It covers:
+  - insert and remove, including their exceptions.
+  - tryInsert and tryRemove.
+  - find, lowerBound, and upperBound.
+  - rank and select.
+  - insertBatch and removeBatch.
+  - split followed by join.
+  - clear.
+The intrusive tree takes the inserts, removes, finds, and clears, linking and unlinking the record for each key.
+
+Built normally, main generates the bytes from a seeded random generator and runs as a stress test. Built with AVL_LIBFUZZER defined and -fsanitize=fuzzer, the
+same operations are driven by libFuzzer through LLVMFuzzerTestOneInput instead, and it searches for inputs that reach new paths. Both builds are meant to run
+under AddressSanitizer and UndefinedBehaviorSanitizer.
+
+Compilation Instructions:
+	Using Ubuntu 22.04:
+		cmake -S . -B build && cmake --build build --target avl_stress && build/avl_stress [runs] [seed]
+		or g++ -std=c++17 -O1 -g -fsanitize=address,undefined AVLTreeFuzz.cpp -o avl_stress -pthread
+	Using clang for libFuzzer:
+		clang++ -std=c++17 -O1 -g -DAVL_LIBFUZZER -fsanitize=fuzzer,address,undefined AVLTreeFuzz.cpp -o avl_fuzz -pthread
+		or cmake -S . -B build -DCMAKE_CXX_COMPILER=clang++ && cmake --build build --target avl_fuzz
+*/
+#include "AVLTemplateClass.h"
+#include "AVLIntrusiveTemplateClass.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+using PlainTree = BinarySearchTree<int>;
+using StatisticTree = BinarySearchTree<int, ThreeWayCompare<int>, PoolAllocator<int>, true>;
+
+//Record linked into the intrusive tree, one for each key, ordered by the key.
+struct KeyRecord : AVLHook<>
+{
+	int key = 0;
+
+	bool operator<(const KeyRecord& other) const
+	{
+		return key < other.key;
+	}
+};
+using IntrusiveTree = IntrusiveAVLTree<KeyRecord>;
+
+//Each operation takes three bytes: the operation, then two bytes of key. Keys are kept to KEY_RANGE values, so inserts and removes often find keys present.
+const size_t OPERATION_BYTES = 3;
+const int KEY_RANGE = 1024;
+const int OPERATION_COUNT = 12;
+
+/*
+Fail function reports a difference between a tree and the std::set, then aborts so that both the stress driver and libFuzzer stop at the failing input.
+
+@param[in]: The operation number and a description of the difference.
+@return: Nothing. The program aborts.
+*/
+[[noreturn]] void fail(size_t operation, const string& message)
+{
+	fprintf(stderr, "Operation %zu: %s\n", operation, message.c_str());
+	abort();
+}
+
+/*
+Check contents functions compare every value of a tree with the std::set, in order, reading the keys of the records for the intrusive tree.
+
+@param[in]: The tree, the std::set, the operation number, and the tree's name for the report where there is more than one tree of the type.
+@return: Nothing, or an abort at the first difference.
+*/
+template <typename TREE>
+void checkContents(const TREE& tree, const set<int>& expected, size_t operation, const string& name)
+{
+	if (tree.count() != (int)expected.size() || !equal(tree.begin(), tree.end(), expected.begin()))
+		fail(operation, name + " contents differ from std::set");
+}
+void checkContents(const IntrusiveTree& tree, const set<int>& expected, size_t operation)
+{
+	if (!equal(tree.begin(), tree.end(), expected.begin(), expected.end(), [](const KeyRecord& record, int key) { return record.key == key; }))
+		fail(operation, "intrusive tree contents differ from std::set");
+}
+
+/*
+Apply operation function applies one operation to a tree and compares its result with the result std::set gives. The std::set is updated by the caller.
+
+@param[in]: The tree, the std::set before the operation, the operation code and key, and the operation number.
+@return: Nothing, or an abort at the first difference.
+*/
+template <typename TREE>
+void applyOperation(TREE& tree, const set<int>& expected, int code, int key, size_t operation, const string& name)
+{
+	bool present = expected.count(key) > 0;
+	switch (code)
+	{
+	case 0:
+	case 1:
+	{
+		bool threw = false;
+		try
+		{
+			tree.insert(key);
+		}
+		catch (DuplicateItemException&)
+		{
+			threw = true;
+		}
+		if (threw != present)
+			fail(operation, name + " insert disagrees on whether the key was present");
+		break;
+	}
+	case 2:
+		if (tree.tryInsert(key).second == present)
+			fail(operation, name + " tryInsert disagrees on whether the key was present");
+		break;
+	case 3:
+	case 4:
+	{
+		bool threw = false;
+		try
+		{
+			tree.remove(key);
+		}
+		catch (ItemNotFoundException&)
+		{
+			threw = true;
+		}
+		if (threw == present)
+			fail(operation, name + " remove disagrees on whether the key was present");
+		break;
+	}
+	case 5:
+		if (tree.tryRemove(key) != present)
+			fail(operation, name + " tryRemove disagrees on whether the key was present");
+		break;
+	case 6:
+	{
+		const int* found = tree.find(key);
+		if ((found != nullptr) != present || (found && *found != key))
+			fail(operation, name + " find differs from std::set");
+		break;
+	}
+	case 7:
+	{
+		auto lower = tree.lowerBound(key);
+		auto upper = tree.upperBound(key);
+		auto expectedLower = expected.lower_bound(key);
+		auto expectedUpper = expected.upper_bound(key);
+		if ((lower == tree.end()) != (expectedLower == expected.end()) || (lower != tree.end() && *lower != *expectedLower))
+			fail(operation, name + " lowerBound differs from std::set");
+		if ((upper == tree.end()) != (expectedUpper == expected.end()) || (upper != tree.end() && *upper != *expectedUpper))
+			fail(operation, name + " upperBound differs from std::set");
+		break;
+	}
+	case 8:
+	case 9:
+	{
+		//A short sorted batch with a repeat, starting at the key and stepping by a stride taken from the key.
+		vector<int> batch;
+		int stride = 1 + key % 7;
+		for (int i = 0; i < 8; i++)
+			batch.push_back((key + i * stride) % KEY_RANGE);
+		sort(batch.begin(), batch.end());
+		batch.push_back(batch.back());
+		int expectedChanged = 0;
+		set<int> distinct(batch.begin(), batch.end());
+		for (int item : distinct)
+			expectedChanged += (expected.count(item) > 0) == (code == 9);
+		int changed = code == 8 ? tree.insertBatch(batch.begin(), batch.end()) : tree.removeBatch(batch.begin(), batch.end());
+		if (changed != expectedChanged)
+			fail(operation, name + (code == 8 ? " insertBatch" : " removeBatch") + " changed a different number of keys than std::set");
+		break;
+	}
+	case 10:
+	{
+		TREE upper;
+		tree.split(key, upper);
+		tree.validate();
+		upper.validate();
+		if (tree.count() != (int)distance(expected.begin(), expected.lower_bound(key)) || (upper.count() && *upper.begin() < key))
+			fail(operation, name + " split did not divide the keys at the split key");
+		tree.join(upper);
+		if (upper.count())
+			fail(operation, name + " join left values in the joined tree");
+		break;
+	}
+	default:
+		//Clear rarely, so the trees have time to grow between clears.
+		if (key % 64 == 0)
+			tree.clear();
+		break;
+	}
+}
+
+/*
+Apply intrusive operation function applies the operations the intrusive tree supports to it, linking or unlinking the record for the key, and compares its result
+with the result std::set gives.
+
+@param[in]: The tree, the records, the std::set before the operation, the operation code and key, and the operation number.
+@return: Nothing, or an abort at the first difference.
+*/
+void applyIntrusiveOperation(IntrusiveTree& tree, vector<KeyRecord>& records, const set<int>& expected, int code, int key, size_t operation)
+{
+	bool present = expected.count(key) > 0;
+	KeyRecord& record = records[key];
+	if (record.isLinked() != present)
+		fail(operation, "intrusive record linked state differs from std::set");
+	if (code <= 2)
+	{
+		//A linked record cannot be linked again, so a present key is tried with an unlinked copy of its record, which must be refused as a duplicate.
+		KeyRecord copy = record;
+		if (tree.tryInsert(present ? copy : record).second == present || copy.isLinked())
+			fail(operation, "intrusive tryInsert disagrees on whether the key was present");
+	}
+	else if (code <= 5)
+	{
+		if (present)
+			tree.remove(record);
+	}
+	else if (code == 6)
+	{
+		if ((tree.find(record) != nullptr) != present)
+			fail(operation, "intrusive find differs from std::set");
+	}
+	else if (code == OPERATION_COUNT - 1 && key % 64 == 0)
+		tree.clear();
+}
+
+/*
+Check statistics function compares rank and select of the order statistic tree with the std::set, at the key and at the position the key gives.
+
+@param[in]: The tree, the std::set, the key, and the operation number.
+@return: Nothing, or an abort at the first difference.
+*/
+void checkStatistics(const StatisticTree& tree, const set<int>& expected, int key, size_t operation)
+{
+	if (tree.rank(key) != (int)distance(expected.begin(), expected.lower_bound(key)))
+		fail(operation, "rank differs from std::set");
+	if (!expected.empty())
+	{
+		int position = key % (int)expected.size();
+		if (tree.select(position) != *next(expected.begin(), position))
+			fail(operation, "select differs from std::set");
+	}
+}
+
+/*
+Run operations function applies the operations encoded in the bytes to the trees and the std::set, validating the trees after each one and comparing their
+contents every so often and at the end.
+
+@param[in]: The bytes, and their number.
+@return: Nothing, or an abort at the first difference or broken invariant.
+*/
+void runOperations(const uint8_t* data, size_t size)
+{
+	PlainTree plainTree;
+	StatisticTree statisticTree;
+	vector<KeyRecord> records(KEY_RANGE);
+	for (int key = 0; key < KEY_RANGE; key++)
+		records[key].key = key;
+	IntrusiveTree intrusiveTree;
+	set<int> expected;
+	size_t operations = size / OPERATION_BYTES;
+	for (size_t operation = 0; operation < operations; operation++)
+	{
+		const uint8_t* bytes = data + operation * OPERATION_BYTES;
+		int code = bytes[0] % OPERATION_COUNT;
+		int key = (bytes[1] << 8 | bytes[2]) % KEY_RANGE;
+		applyOperation(plainTree, expected, code, key, operation, "BinarySearchTree");
+		applyOperation(statisticTree, expected, code, key, operation, "order statistic tree");
+		//The intrusive tree follows the std::set through the batch operations, which it does not support, by linking and unlinking the same keys.
+		applyIntrusiveOperation(intrusiveTree, records, expected, code, key, operation);
+
+		//Bring the std::set into line with the operation.
+		if (code <= 2)
+			expected.insert(key);
+		else if (code <= 5)
+			expected.erase(key);
+		else if (code == 8 || code == 9)
+		{
+			int stride = 1 + key % 7;
+			for (int i = 0; i < 8; i++)
+			{
+				KeyRecord& record = records[(key + i * stride) % KEY_RANGE];
+				if (code == 8)
+				{
+					expected.insert(record.key);
+					if (!record.isLinked())
+						intrusiveTree.insert(record);
+				}
+				else
+				{
+					expected.erase(record.key);
+					if (record.isLinked())
+						intrusiveTree.remove(record);
+				}
+			}
+		}
+		else if (code == OPERATION_COUNT - 1 && key % 64 == 0)
+			expected.clear();
+
+		try
+		{
+			plainTree.validate();
+			statisticTree.validate();
+			intrusiveTree.validate();
+		}
+		catch (InvalidTreeException& exception)
+		{
+			fail(operation, exception.toString());
+		}
+		if (plainTree.count() != (int)expected.size() || statisticTree.count() != (int)expected.size() || intrusiveTree.count() != (int)expected.size())
+			fail(operation, "count differs from std::set");
+		checkStatistics(statisticTree, expected, key, operation);
+		if (operation % 64 == 63)
+		{
+			checkContents(plainTree, expected, operation, "BinarySearchTree");
+			checkContents(statisticTree, expected, operation, "order statistic tree");
+			checkContents(intrusiveTree, expected, operation);
+		}
+	}
+	checkContents(plainTree, expected, operations, "BinarySearchTree");
+	checkContents(statisticTree, expected, operations, "order statistic tree");
+	checkContents(intrusiveTree, expected, operations);
+}
+
+#ifdef AVL_LIBFUZZER
+/*
+LLVMFuzzerTestOneInput is the entry point libFuzzer calls with each input it generates.
+
+@param[in]: The bytes of the input, and their number.
+@return: Zero. Differences abort instead.
+*/
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	runOperations(data, size);
+	return 0;
+}
+#else
+/*
+Main function runs the stress test: a number of runs, each of a few thousand random operations on fresh trees.
+
+@param[in]: Optionally the number of runs, and the seed of the random generator.
+@return: Text output of the number of operations run, and zero, or an abort at the first difference.
+*/
+int main(int argc, char* argv[])
+{
+	int runs = argc > 1 ? atoi(argv[1]) : 500;
+	unsigned seed = argc > 2 ? (unsigned)strtoul(argv[2], nullptr, 10) : 12345;
+	mt19937 generator(seed);
+	size_t totalOperations = 0;
+	for (int run = 0; run < runs; run++)
+	{
+		//Runs vary in length, so some trees stay small and some grow to fill most of the key range.
+		vector<uint8_t> bytes(OPERATION_BYTES * (100 + generator() % 4000));
+		for (uint8_t& byte : bytes)
+			byte = (uint8_t)generator();
+		runOperations(bytes.data(), bytes.size());
+		totalOperations += bytes.size() / OPERATION_BYTES;
+	}
+	cout << "Differential stress test passed: " << totalOperations << " operations in " << runs << " runs, seed " << seed << endl;
+	return 0;
+}
+#endif
@@ -9,17 +9,31 @@ includes the implementation of insertion, deletion, search, and count functions
 
 Compilation Instructions:
 	Using Ubuntu 22.04:
-		g++ -c AVLTreeTestMain.cpp -o main.o
-		g++ -c AVLTemplateClass.cpp -o templateCode.o
-		g++ main.o templateCode.o -o AVLTreeTest
+		cmake -S . -B build && cmake --build build && ctest --test-dir build
+		or g++ -std=c++17 AVLTreeTestMain.cpp -o AVLTreeTest -pthread
 	Using Visual Studio:
 		Run local Windows debugger
 */
 #include "AVLTemplateClass.h"
+#include "AVLMapTemplateClass.h"
+#include "AVLMultisetTemplateClass.h"
+#include "AVLCompactTemplateClass.h"
+#include "AVLFrozenTemplateClass.h"
+#include "AVLConcurrentTemplateClass.h"
+#include "AVLPersistentTemplateClass.h"
+#include "AVLShardedTemplateClass.h"
+#include "AVLImageTemplateClass.h"
+#include "AVLIntrusiveTemplateClass.h"
+#include <climits>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
 
 /*
-Compare function used as pointer parameter in tree construction. Function returns -1, 0, or 1 based on the comparison
-of two items.
+Compare function used as pointer parameter in tree construction when the tree is built with the CompareFunction policy. Function returns -1, 0, or 1
+based on the comparison of two items.
 
 @param[in]: Two TYPE items to be compared.
 @return: -1,0, or 1 based on the comparison of the inputs.
@@ -34,20 +48,110 @@ int compare(const TYPE& item1, const TYPE& item2)
 	return 1;
 }
 
+/*
+Counting compare class is a compare policy that records how many comparisons the tree makes, so tests can check how many times a descent compares items.
+
+@param[in]: A counter to add each comparison to.
+@return: -1,0, or 1 based on the comparison of the inputs.
+*/
+struct CountingCompare
+{
+	int* comparisons;
+
+	int operator()(int item1, int item2) const
+	{
+		(*comparisons)++;
+		return compare(item1, item2);
+	}
+};
+
+/*
+Throwing compare class is a compare policy that throws once its budget of comparisons runs out, so tests can make an operation fail partway through. The budget
+is shared and atomic, since set operations may compare on several threads.
+
+@param[in]: The comparisons left before it throws.
+@return: -1,0, or 1 based on the comparison of the inputs.
+*/
+struct ThrowingCompare
+{
+	atomic<int>* budget;
+
+	int operator()(int item1, int item2) const
+	{
+		if (budget->fetch_sub(1) <= 0)
+			throw runtime_error("Compare failed");
+		return compare(item1, item2);
+	}
+};
+
+/*
+Record struct is an object indexed by two intrusive trees at once, one ordered by id through its untagged hook and one ordered by name through its ByName hook.
+The compare policies order records by those fields, and the id policy also compares a record against a lone id.
+*/
+struct ByName {};
+struct Record : AVLHook<>, AVLHook<ByName>
+{
+	int id = 0;
+	string name;
+};
+struct RecordIdCompare
+{
+	using is_transparent = void;
+
+	int operator()(const Record& item1, const Record& item2) const
+	{
+		return compare(item1.id, item2.id);
+	}
+	int operator()(const Record& item, int id) const
+	{
+		return compare(item.id, id);
+	}
+};
+struct RecordNameCompare
+{
+	int operator()(const Record& item1, const Record& item2) const
+	{
+		return compare(item1.name, item2.name);
+	}
+};
+
+/*
+Throwing copy struct is a value whose copy constructor throws while failCopies is set, so tests can make a read of the tree throw partway through.
+*/
+struct ThrowingCopy
+{
+	static bool failCopies;
+	int value = 0;
+
+	ThrowingCopy(int item = 0) : value(item) {}
+	ThrowingCopy(const ThrowingCopy& other) : value(other.value)
+	{
+		if (failCopies)
+			throw runtime_error("Copy failed");
+	}
+	ThrowingCopy& operator=(const ThrowingCopy& other) = default;
+	bool operator<(const ThrowingCopy& other) const
+	{
+		return value < other.value;
+	}
+};
+bool ThrowingCopy::failCopies = false;
+
 /*
 Main function facilitates construction of 8 binary search trees to carry out 8 test cases to cover all insertion and deletion rebalancing cases. This is done using
 commands to insert and delete into the tree, as well as additional tests for the search and count functions.
 Test values are used to check the heights and positions of specific nodes in each case, and the test only passes if these values are correct to the expected outcome.
 
 @param[in]: Nothing. Main creates tree objects and manipulates them itself.
-@return: Text output into the output window stating which tests were conducted and which passed.
+@return: Text output into the output window stating which tests were conducted and which passed, and a nonzero exit code if any failed.
 */
 int main(int argc, char* argv[])
 {
 	int testValue1 = -1;
 	int testValue2 = -1;
+	int failedTests = 0;
 
-	BinarySearchTree<int> testTree1(compare);
+	BinarySearchTree<int> testTree1;
 	cout << "Beginning Insertion cases" << endl;
 	testTree1.insert(5);
 	testTree1.insert(2);
@@ -60,8 +164,10 @@ int main(int argc, char* argv[])
 	{
 		cout << "Left-Left Case Passed" << endl;
 	}
+	else
+		failedTests++;
 
-	BinarySearchTree<int> testTree2(compare);
+	BinarySearchTree<int> testTree2;
 	testTree2.insert(5);
 	testTree2.insert(2);
 	testTree2.insert(9);
@@ -73,8 +179,10 @@ int main(int argc, char* argv[])
 	{
 		cout << "Left-Right Case Passed" << endl;
 	}
+	else
+		failedTests++;
 
-	BinarySearchTree<int> testTree3(compare);
+	BinarySearchTree<int> testTree3;
 	testTree3.insert(5);
 	testTree3.insert(2);
 	testTree3.insert(9);
@@ -86,8 +194,10 @@ int main(int argc, char* argv[])
 	{
 		cout << "Right-Left Case Passed" << endl;
 	}
+	else
+		failedTests++;
 
-	BinarySearchTree<int> testTree4(compare);
+	BinarySearchTree<int> testTree4;
 	testTree4.insert(5);
 	testTree4.insert(2);
 	testTree4.insert(9);
@@ -99,10 +209,12 @@ int main(int argc, char* argv[])
 	{
 		cout << "Right-Right Case Passed" << endl << endl;
 	}
+	else
+		failedTests++;
 
 	cout << "Beginning Deletion Cases" << endl;
 
-	BinarySearchTree<int> testTree5(compare);
+	BinarySearchTree<int> testTree5;
 	testTree5.insert(5);
 	testTree5.insert(2);
 	testTree5.insert(8);
@@ -117,8 +229,10 @@ int main(int argc, char* argv[])
 	{
 		cout << "Lefthand and 0/1 Case Passed" << endl;
 	}
+	else
+		failedTests++;
 
-	BinarySearchTree<int> testTree6(compare);
+	BinarySearchTree<int> testTree6;
 	testTree6.insert(5);
 	testTree6.insert(2);
 	testTree6.insert(8);
@@ -133,8 +247,10 @@ int main(int argc, char* argv[])
 	{
 		cout << "Lefthand and -1 Case Passed" << endl;
 	}
+	else
+		failedTests++;
 
-	BinarySearchTree<int> testTree7(compare);
+	BinarySearchTree<int> testTree7;
 	testTree7.insert(8);
 	testTree7.insert(5);
 	testTree7.insert(10);
@@ -154,8 +270,10 @@ int main(int argc, char* argv[])
 	{
 		cout << "Righthand and 1 Case Passed" << endl;
 	}
+	else
+		failedTests++;
 
-	BinarySearchTree<int> testTree8(compare);
+	BinarySearchTree<int, CompareFunction<int>> testTree8(compare);
 	testTree8.insert(8);
 	testTree8.insert(5);
 	testTree8.insert(10);
@@ -175,6 +293,8 @@ int main(int argc, char* argv[])
 	{
 		cout << "Righthand and 0/-1 Case Passed" << endl << endl;
 	}
+	else
+		failedTests++;
 
 	cout << "Beginning supplemental tests" << endl;
 	testValue1 = testTree8.search(5);
@@ -183,7 +303,714 @@ int main(int argc, char* argv[])
 	{
 		cout << "Count and Search tests passed" << endl << endl;
 	}
+	else
+		failedTests++;
+
+	BinarySearchTree<int, ThreeWayCompare<int>, PoolAllocator<int>> poolTree;
+	for (int i = 1; i <= 100; i++)
+		poolTree.insert(i);
+	for (int i = 2; i <= 100; i += 2)
+		poolTree.remove(i);
+	for (int i = 102; i <= 150; i += 2)
+		poolTree.insert(i);
+	BinarySearchTree<string, ThreeWayCompare<string>, PoolAllocator<string>> poolStringTree;
+	poolStringTree.insert("pooled");
+	poolStringTree.insert("string");
+	poolStringTree.remove("pooled");
+	if (poolTree.count() == 75 && poolTree.search(99) == 99 && poolTree.search(150) == 150 && poolStringTree.count() == 1)
+	{
+		cout << "Pool allocator tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	vector<int> sortedItems;
+	for (int i = 1; i <= 15; i++)
+		sortedItems.push_back(i);
+	BinarySearchTree<int> bulkTree(sortedItems.begin(), sortedItems.end());
+	int unsortedItems[] = { 9, 4, 9, 1, 7, 4 };
+	BinarySearchTree<int> unsortedBulkTree(begin(unsortedItems), end(unsortedItems), true);
+	bool unsortedRejected = false;
+	try
+	{
+		bulkTree.assignSorted(begin(unsortedItems), end(unsortedItems));
+	}
+	catch (UnsortedInputException&)
+	{
+		unsortedRejected = true;
+	}
+	if (bulkTree.count() == 15 && bulkTree.returnHeight(8) == 4 && bulkTree.returnHeight(4) == 3 && bulkTree.returnHeight(15) == 1 &&
+		unsortedBulkTree.count() == 4 && unsortedBulkTree.returnHeight(7) == 3 && unsortedRejected)
+	{
+		cout << "Bulk load tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	int iteratorSum = 0;
+	for (int item : bulkTree)
+		iteratorSum += item;
+	int visitCount = 0;
+	testTree8.inOrder([&visitCount](const int&) { visitCount++; });
+	BinarySearchTree<int>::iterator lastItem = bulkTree.end();
+	--lastItem;
+	if (iteratorSum == 120 && *bulkTree.rbegin() == 15 && *lastItem == 15 && is_sorted(testTree7.begin(), testTree7.end()) &&
+		distance(testTree8.rbegin(), testTree8.rend()) == 11 && visitCount == 11)
+	{
+		cout << "Iterator tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	OrderStatisticTree<int> statisticTree(sortedItems.begin(), sortedItems.end());
+	statisticTree.remove(8);
+	statisticTree.insert(20);
+	if (statisticTree.select(0) == 1 && statisticTree.select(7) == 9 && statisticTree.select(14) == 20 && statisticTree.rank(8) == 7 &&
+		statisticTree.rank(21) == 15 && statisticTree.countRange(5, 12) == 7 && statisticTree.countRange(12, 5) == 0)
+	{
+		cout << "Order statistic tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	int rangeSum = 0;
+	statisticTree.forEachInRange(6, 10, [&rangeSum](const int& item) { rangeSum += item; });
+	auto equalItems = testTree8.equalRange(6);
+	if (*bulkTree.lowerBound(0) == 1 && *statisticTree.lowerBound(8) == 9 && *statisticTree.upperBound(9) == 10 && statisticTree.upperBound(20) == statisticTree.end() &&
+		rangeSum == 32 && *equalItems.first == 6 && *equalItems.second == 8 && testTree8.equalRange(7).first == testTree8.equalRange(7).second)
+	{
+		cout << "Range query tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	pair<BinarySearchTree<int>::iterator, bool> firstInsert = testTree1.tryInsert(4);
+	pair<BinarySearchTree<int>::iterator, bool> secondInsert = testTree1.tryInsert(4);
+	if (testTree1.find(4) && *testTree1.find(4) == 4 && !testTree1.find(3) && firstInsert.second && !secondInsert.second &&
+		firstInsert.first == secondInsert.first && testTree1.tryRemove(4) && !testTree1.tryRemove(4) && testTree1.count() == 5)
+	{
+		cout << "Non-throwing lookup tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	BinarySearchTree<string> stringTree;
+	string movedItem = "moved";
+	stringTree.insert(std::move(movedItem));
+	bool emplaced = stringTree.emplace(3, 'x').second;
+	bool duplicateEmplaced = stringTree.emplace("moved").second;
+	BinarySearchTree<int>::iterator stableItem = bulkTree.lowerBound(7);
+	bulkTree.remove(8);
+	if (emplaced && !duplicateEmplaced && &stringTree.search("xxx") == stringTree.find("xxx") && stringTree.count() == 2 && *stableItem == 7 &&
+		*++stableItem == 9)
+	{
+		cout << "Move and emplace tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	AVLMap<string, int, ThreeWayCompare<>> wordCounts;
+	wordCounts["apple"] += 2;
+	wordCounts["pear"]++;
+	wordCounts["apple"]++;
+	bool assignedNew = wordCounts.insert_or_assign("plum", 7).second;
+	bool assignedOld = wordCounts.insert_or_assign("pear", 5).second;
+	bool missingRejected = false;
+	try
+	{
+		wordCounts.at("fig");
+	}
+	catch (ItemNotFoundException&)
+	{
+		missingRejected = true;
+	}
+	const AVLMap<string, int, ThreeWayCompare<>>& constWordCounts = wordCounts;
+	bool boundsMatch = constWordCounts.at(string_view("pear")) == 5 && wordCounts.lowerBound(string_view("b"))->first == "pear" &&
+		wordCounts.upperBound(string_view("pear"))->first == "plum" && wordCounts.upperBound(string_view("zebra")) == wordCounts.end();
+	if (wordCounts.at(string_view("apple")) == 3 && *wordCounts.find(string_view("pear")) == 5 && !wordCounts.find(string_view("fig")) && assignedNew && !assignedOld &&
+		missingRejected && boundsMatch && wordCounts.count() == 3 && wordCounts.begin()->first == "apple" && wordCounts.tryRemove(string_view("plum")) && wordCounts.count() == 2)
+	{
+		cout << "Map tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	poolTree.clear();
+	poolTree.insert(42);
+	poolStringTree.clear();
+	testTree5.clear();
+	if (poolTree.count() == 1 && poolTree.search(42) == 42 && poolStringTree.count() == 0 && testTree5.count() == 0 && testTree5.begin() == testTree5.end())
+	{
+		cout << "Clear tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	int comparisons = 0;
+	BinarySearchTree<int, CountingCompare> countingTree(CountingCompare{ &comparisons });
+	vector<int> perfectKeys = { 1, 2, 3, 4, 5, 6, 7 };
+	countingTree.assignSorted(perfectKeys.begin(), perfectKeys.end());
+	comparisons = 0;
+	countingTree.insert(8);
+	int insertComparisons = comparisons;
+	comparisons = 0;
+	bool found = countingTree.find(5) != nullptr;
+	int findComparisons = comparisons;
+	countingTree.remove(1);
+	countingTree.remove(8);
+	if (insertComparisons == 3 && found && findComparisons == 3 && countingTree.returnHeight(4) == 3 && countingTree.returnHeight(2) == 2 &&
+		countingTree.returnHeight(6) == 2 && countingTree.returnHeight(7) == 1)
+	{
+		cout << "Single comparison descent tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	CompactBinarySearchTree<int> compactTree;
+	compactTree.insert(5);
+	compactTree.insert(2);
+	compactTree.insert(8);
+	compactTree.insert(7);
+	compactTree.insert(6);
+	bool compactLeftLeft = compactTree.returnHeight(7) == 2 && compactTree.returnHeight(8) == 1;
+	compactTree.remove(2);
+	compactTree.remove(5);
+	CompactBinarySearchTree<string> compactStringTree;
+	vector<string> compactWords = { "pear", "apple", "fig", "plum", "apple" };
+	compactStringTree.assignSorted(compactWords.begin(), compactWords.end(), true);
+	compactStringTree.remove("fig");
+	bool compactDuplicateRejected = false;
+	try
+	{
+		compactStringTree.insert("plum");
+	}
+	catch (DuplicateItemException&)
+	{
+		compactDuplicateRejected = true;
+	}
+	//A compare that throws on a negative value must leave no unlinked node behind in the node vector.
+	CompactBinarySearchTree<int, CompareFunction<int>> throwingCompactTree([](const int& item1, const int& item2) {
+		if (item1 < 0 || item2 < 0)
+			throw Exception(__LINE__, "Negative value compared");
+		return compare(item1, item2);
+	});
+	throwingCompactTree.insert(1);
+	throwingCompactTree.insert(2);
+	bool compactThrowRolledBack = false;
+	try
+	{
+		throwingCompactTree.emplace(-1);
+	}
+	catch (Exception&)
+	{
+		compactThrowRolledBack = throwingCompactTree.count() == 2 && distance(throwingCompactTree.begin(), throwingCompactTree.end()) == 2;
+	}
+	if (compactLeftLeft && compactThrowRolledBack && compactTree.count() == 3 && *compactTree.begin() == 6 && *compactTree.rbegin() == 8 && compactTree.returnHeight(7) == 2 &&
+		!compactTree.find(5) && compactStringTree.count() == 3 && compactStringTree.search("pear") == "pear" && *compactStringTree.lowerBound("b") == "pear" &&
+		compactDuplicateRejected && CompactBinarySearchTree<int>::bytesPerNode() == 16)
+	{
+		cout << "Compact layout tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	BinarySearchTree<int> frozenSource;
+	for (int i = 1; i <= 100; i++)
+		frozenSource.insert(i * 2);
+	FrozenSearchTree<int> frozenInts = frozenSource.freeze();
+	frozenSource.insert(3);
+	bool frozenIntsMatch = frozenInts.count() == 100 && !frozenInts.contains(3) && !frozenInts.lowerBound(201);
+	for (int probe = -1; probe <= 201; probe++)
+	{
+		BinarySearchTree<int>::Iterator expected = frozenSource.lowerBound(probe == 3 ? 4 : probe);
+		const int* bound = frozenInts.lowerBound(probe);
+		if ((bound == nullptr) != (expected == frozenSource.end()) || (bound && *bound != *expected) || frozenInts.contains(probe) != (probe > 0 && probe % 2 == 0 && probe <= 200))
+			frozenIntsMatch = false;
+	}
+	FrozenSearchTree<string, ThreeWayCompare<>> frozenWords = BinarySearchTree<string, ThreeWayCompare<>>(compactWords.begin(), compactWords.end(), true).freeze();
+	if (frozenIntsMatch && frozenWords.contains(string_view("fig")) && !frozenWords.contains("kiwi") && *frozenWords.lowerBound("b") == "fig" &&
+		!frozenWords.lowerBound("zebra") && FrozenSearchTree<int>::BLOCKED && !FrozenSearchTree<string>::BLOCKED)
+	{
+		cout << "Frozen snapshot tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	vector<int> batchKeys;
+	for (int probe = -5; probe <= 210; probe += 3)
+		batchKeys.push_back(probe);
+	vector<const int*> batchResults;
+	frozenSource.searchBatch(batchKeys, batchResults);
+	bool batchMatches = batchResults.size() == batchKeys.size();
+	for (size_t i = 0; batchMatches && i < batchKeys.size(); i++)
+		batchMatches = batchResults[i] == frozenSource.find(batchKeys[i]);
+	BinarySearchTree<int> emptyBatchTree;
+	emptyBatchTree.searchBatch(batchKeys, batchResults);
+	if (batchMatches && batchResults.size() == batchKeys.size() && batchResults[0] == nullptr)
+	{
+		cout << "Batch search tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	ConcurrentBinarySearchTree<int> sharedTree;
+	for (int i = 0; i < 2000; i += 2)
+		sharedTree.insert(i);
+	atomic<bool> sharedTreeConsistent{ true };
+	vector<thread> workers;
+	for (int writer = 0; writer < 2; writer++)
+	{
+		workers.emplace_back([&sharedTree, writer]() {
+			for (int round = 0; round < 20; round++)
+			{
+				for (int i = 1 + writer * 1000; i < 1000 + writer * 1000; i += 2)
+					sharedTree.insert(i);
+				for (int i = 1 + writer * 1000; i < 1000 + writer * 1000; i += 2)
+					sharedTree.remove(i);
+			}
+		});
+	}
+	for (int reader = 0; reader < 2; reader++)
+	{
+		workers.emplace_back([&sharedTree, &sharedTreeConsistent]() {
+			for (int round = 0; round < 2000; round++)
+			{
+				int key = (round * 37) % 2000;
+				if (key % 2 == 0 && sharedTree.search(key) != key)
+					sharedTreeConsistent = false;
+				int previous = -1;
+				int evens = 0;
+				sharedTree.forEachInRange(900, 1100, [&](int value) {
+					if (value <= previous)
+						sharedTreeConsistent = false;
+					previous = value;
+					evens += value % 2 == 0;
+				});
+				if (evens != 101)
+					sharedTreeConsistent = false;
+			}
+		});
+	}
+	for (thread& worker : workers)
+		worker.join();
+	//A read that throws must still leave its epoch, or the reclaim after enough removals would wait for it forever.
+	ConcurrentBinarySearchTree<ThrowingCopy> throwingTree;
+	for (int i = 0; i < 2000; i++)
+		throwingTree.insert(i);
+	bool readThrew = false;
+	ThrowingCopy::failCopies = true;
+	try
+	{
+		throwingTree.find(1000);
+	}
+	catch (const runtime_error&)
+	{
+		readThrew = true;
+	}
+	ThrowingCopy::failCopies = false;
+	for (int i = 0; i < 2000; i++)
+		throwingTree.remove(i);
+	if (sharedTreeConsistent && readThrew && throwingTree.count() == 0 && sharedTree.count() == 1000 && sharedTree.contains(1998) && !sharedTree.find(1999))
+	{
+		cout << "Concurrent stress tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	PersistentBinarySearchTree<int> versionedTree;
+	for (int i = 0; i < 1000; i++)
+		versionedTree.insert(i);
+	PersistentBinarySearchTree<int>::Snapshot fullVersion = versionedTree.snapshot();
+	for (int i = 0; i < 1000; i += 2)
+		versionedTree.remove(i);
+	PersistentBinarySearchTree<int>::Snapshot oddVersion = versionedTree.snapshot();
+	int fullVisited = 0;
+	fullVersion.inOrder([&](int value) { fullVisited += value == fullVisited; });
+	int oddVisited = 0;
+	oddVersion.forEachInRange(100, 199, [&](int value) { oddVisited += value % 2; });
+	bool versionsIntact = fullVersion.count() == 1000 && fullVisited == 1000 && fullVersion.contains(500) && oddVersion.count() == 500 && !oddVersion.contains(500)
+		&& oddVisited == 50 && *oddVersion.lowerBound(500) == 501 && oddVersion.versionNumber() == fullVersion.versionNumber() + 500;
+	//Snapshots order values with the tree's own compare, here a descending function pointer, rather than a default one.
+	PersistentBinarySearchTree<int, CompareFunction<int>> descendingTree([](const int& item1, const int& item2) { return compare(item2, item1); });
+	for (int i = 0; i < 100; i++)
+		if (i != 50)
+			descendingTree.insert(i);
+	PersistentBinarySearchTree<int, CompareFunction<int>>::Snapshot descendingVersion = descendingTree.snapshot();
+	vector<int> descendingVisited;
+	descendingVersion.forEachInRange(60, 40, [&](int value) { descendingVisited.push_back(value); });
+	bool descendingIntact = descendingVersion.contains(42) && !descendingVersion.find(50) && *descendingVersion.lowerBound(50) == 49 &&
+		descendingVisited.size() == 20 && descendingVisited.front() == 60 && descendingVisited.back() == 40;
+	PersistentBinarySearchTree<int>::WriteStats pathCopies = versionedTree.lastWriteStats();
+	if (versionsIntact && descendingIntact && !versionedTree.tryInsert(1) && versionedTree.tryRemove(1) && pathCopies.nodesCopied > 0 && pathCopies.nodesCopied <= 3 * 10
+		&& versionedTree.totalWriteStats().writes == 1501)
+	{
+		cout << "Persistent snapshot tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	ShardedAVL<int> shardedTree(4);
+	vector<thread> shardWriters;
+	for (int writer = 0; writer < 4; writer++)
+	{
+		shardWriters.emplace_back([&shardedTree, writer]() {
+			for (int i = writer; i < 20000; i += 4)
+				shardedTree.insert(i);
+			for (int i = writer; i < 20000; i += 8)
+				shardedTree.remove(i);
+		});
+	}
+	for (thread& writer : shardWriters)
+		writer.join();
+	int shardedPrevious = -1;
+	bool shardedOrdered = true;
+	shardedTree.inOrder([&](int value) {
+		shardedOrdered = shardedOrdered && value > shardedPrevious && value % 8 >= 4;
+		shardedPrevious = value;
+	});
+	vector<int> shardSizes = shardedTree.shardSizes();
+	int shardedRange = 0;
+	shardedTree.forEachInRange(5000, 5999, [&](int) { shardedRange++; });
+	if (shardedOrdered && shardedTree.count() == 10000 && shardedRange == 500 && shardedTree.rebalanceCount() > 0 && shardedTree.contains(19999)
+		&& !shardedTree.find(19992) && *max_element(shardSizes.begin(), shardSizes.end()) < 10000)
+	{
+		cout << "Sharded tree tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	BinarySearchTree<int> evenSet;
+	BinarySearchTree<int> tripleSet;
+	for (int i = 0; i < 3000; i++)
+	{
+		if (i % 2 == 0)
+			evenSet.insert(i);
+		if (i % 3 == 0)
+			tripleSet.insert(i);
+	}
+	BinarySearchTree<int> unionSet(evenSet.begin(), evenSet.end());
+	BinarySearchTree<int> unionOther(tripleSet.begin(), tripleSet.end());
+	unionSet.unionWith(unionOther);
+	BinarySearchTree<int> intersectSet(evenSet.begin(), evenSet.end());
+	BinarySearchTree<int> intersectOther(tripleSet.begin(), tripleSet.end());
+	intersectSet.intersectWith(intersectOther);
+	evenSet.differenceWith(tripleSet);
+	bool setsMatch = unionSet.count() == 2000 && intersectSet.count() == 500 && evenSet.count() == 1000 && tripleSet.count() == 0 && unionOther.count() == 0;
+	for (int i = 0; i < 3000 && setsMatch; i++)
+		setsMatch = (unionSet.find(i) != nullptr) == (i % 2 == 0 || i % 3 == 0) && (intersectSet.find(i) != nullptr) == (i % 6 == 0)
+			&& (evenSet.find(i) != nullptr) == (i % 2 == 0 && i % 3 != 0);
+	BinarySearchTree<int> upperSet;
+	unionSet.split(1500, upperSet);
+	bool splitMatches = unionSet.count() == 1000 && upperSet.count() == 1000 && *unionSet.rbegin() == 1498 && *upperSet.begin() == 1500;
+	unionSet.join(upperSet);
+	bool joinRejected = false;
+	try
+	{
+		intersectSet.join(evenSet);
+	}
+	catch (UnsortedInputException&)
+	{
+		joinRejected = true;
+	}
+	//A compare that throws partway through frees both trees rather than leaking them, and leaves them empty and usable.
+	atomic<int> compareBudget{ INT_MAX };
+	BinarySearchTree<int, ThrowingCompare> failingSet(ThrowingCompare{ &compareBudget });
+	BinarySearchTree<int, ThrowingCompare> failingOther(ThrowingCompare{ &compareBudget });
+	for (int i = 0; i < 3000; i++)
+	{
+		failingSet.insert(i * 2);
+		failingOther.insert(i * 3);
+	}
+	bool failedUnionEmptied = false;
+	compareBudget = 500;
+	try
+	{
+		failingSet.unionWith(failingOther);
+	}
+	catch (const runtime_error&)
+	{
+		compareBudget = INT_MAX;
+		failingSet.validate();
+		failingSet.insert(1);
+		failedUnionEmptied = failingSet.count() == 1 && failingOther.count() == 0;
+	}
+	if (setsMatch && splitMatches && joinRejected && failedUnionEmptied && unionSet.count() == 2000 && upperSet.count() == 0 && distance(unionSet.begin(), unionSet.end()) == 2000)
+	{
+		cout << "Set operation tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	BinarySearchTree<int> batchTree;
+	vector<int> firstBatch;
+	for (int i = 0; i < 1000; i += 2)
+		firstBatch.push_back(i);
+	vector<int> secondBatch = { -4, 0, 0, 7, 998, 1001 };
+	vector<int> batchDuplicates;
+	int firstInserted = batchTree.insertBatch(firstBatch.begin(), firstBatch.end());
+	int secondInserted = batchTree.insertBatch(secondBatch.begin(), secondBatch.end(), &batchDuplicates);
+	vector<int> removals = { -10, -4, 7, 7, 500, 999 };
+	vector<int> batchNotFound;
+	int removed = batchTree.removeBatch(removals.begin(), removals.end(), &batchNotFound);
+	bool unsortedBatchRejected = false;
+	try
+	{
+		batchTree.removeBatch(secondBatch.rbegin(), secondBatch.rend());
+	}
+	catch (UnsortedInputException&)
+	{
+		unsortedBatchRejected = true;
+	}
+	//A compare that throws once the batch passed its order check, partway through the merge or removal, leaves the tree empty and usable.
+	int failedBatchesEmptied = 0;
+	for (bool inserting : { true, false })
+	{
+		BinarySearchTree<int, ThrowingCompare> failingBatchTree(ThrowingCompare{ &compareBudget });
+		for (int i = 0; i < 3000; i++)
+			failingBatchTree.insert(i);
+		compareBudget = 500;
+		try
+		{
+			if (inserting)
+				failingBatchTree.insertBatch(firstBatch.begin(), firstBatch.end());
+			else
+				failingBatchTree.removeBatch(firstBatch.begin(), firstBatch.end());
+		}
+		catch (const runtime_error&)
+		{
+			compareBudget = INT_MAX;
+			failingBatchTree.validate();
+			failingBatchTree.insert(1);
+			failedBatchesEmptied += failingBatchTree.count() == 1;
+		}
+		compareBudget = INT_MAX;
+	}
+	bool failedBatchEmptied = failedBatchesEmptied == 2;
+	if (firstInserted == 500 && secondInserted == 3 && batchDuplicates == vector<int>{ 0, 0, 998 } && removed == 3 && batchNotFound == vector<int>{ -10, 7, 999 }
+		&& unsortedBatchRejected && failedBatchEmptied && batchTree.count() == 500 && !batchTree.find(500) && batchTree.find(1001))
+	{
+		cout << "Batch insert and remove tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	const string imagePath = "AVLTreeTestImage.bin";
+	BinarySearchTree<int> imageSource;
+	for (int i = 0; i < 300; i++)
+		imageSource.insert((i * 37) % 300 * 3);
+	imageSource.save(imagePath);
+	BinarySearchTree<int> imageLoaded;
+	imageLoaded.insert(-1);
+	imageLoaded.load(imagePath);
+	bool imageLoadMatch = imageLoaded.count() == 300 && equal(imageLoaded.begin(), imageLoaded.end(), imageSource.begin()) && !imageLoaded.find(-1);
+	bool imageMapMatch = false;
+	{
+		MappedSearchTree<int> mappedInts(imagePath);
+		imageMapMatch = mappedInts.count() == 300;
+		for (int probe = -2; probe <= 900; probe++)
+		{
+			const int* bound = mappedInts.lowerBound(probe);
+			int expected = (probe + 2) / 3 * 3;
+			if (mappedInts.contains(probe) != (probe >= 0 && probe % 3 == 0 && probe < 900) || (bound == nullptr) != (expected >= 900) || (bound && *bound != expected))
+				imageMapMatch = false;
+		}
+	}
+	bool imageTypeRejected = false;
+	try
+	{
+		BinarySearchTree<double> imageDoubles;
+		imageDoubles.load(imagePath);
+	}
+	catch (TreeImageException&)
+	{
+		imageTypeRejected = true;
+	}
+	bool imageCorruptRejected = false;
+	{
+		fstream corrupt(imagePath, ios::in | ios::out | ios::binary);
+		corrupt.seekp(0, ios::end);
+		corrupt.seekp((streamoff)corrupt.tellp() - 4);
+		uint32_t backwards = 0;
+		corrupt.write(reinterpret_cast<const char*>(&backwards), sizeof(backwards));
+	}
+	try
+	{
+		imageLoaded.load(imagePath);
+	}
+	catch (TreeImageException&)
+	{
+		imageCorruptRejected = true;
+	}
+	//A save that cannot write its image leaves the previous image at the path in place, and a save that succeeds leaves no temporary file behind.
+	imageSource.save(imagePath);
+	bool imageSaveKept = !filesystem::exists(imagePath + ".tmp");
+	filesystem::create_directory(imagePath + ".tmp");
+	try
+	{
+		BinarySearchTree<int>().save(imagePath);
+		imageSaveKept = false;
+	}
+	catch (TreeImageException&)
+	{
+		imageSaveKept = imageSaveKept && MappedSearchTree<int>(imagePath).count() == 300;
+	}
+	filesystem::remove(imagePath + ".tmp");
+	//A header claiming more records than an int can count is rejected before its size is even checked.
+	bool imageOversizeRejected = false;
+	imageSource.save(imagePath);
+	{
+		fstream oversized(imagePath, ios::in | ios::out | ios::binary);
+		oversized.seekp(offsetof(TreeImageHeader, nodeCount));
+		uint64_t claimedCount = (uint64_t)INT_MAX + 1;
+		oversized.write(reinterpret_cast<const char*>(&claimedCount), sizeof(claimedCount));
+	}
+	try
+	{
+		MappedSearchTree<int> mappedOversized(imagePath);
+	}
+	catch (TreeImageException& error)
+	{
+		imageOversizeRejected = error.toString().find("more items") != string::npos;
+	}
+	remove(imagePath.c_str());
+	if (imageLoadMatch && imageMapMatch && imageTypeRejected && imageCorruptRejected && imageSaveKept && imageOversizeRejected && imageLoaded.count() == 300)
+	{
+		cout << "Image save and load tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+#ifdef AVL_TREE_STATS
+	BinarySearchTree<int> statsTree;
+	statsTree.insert(1);
+	statsTree.insert(2);
+	statsTree.insert(3);
+	statsTree.search(3);
+	TreeStats insertStats = statsTree.stats();
+	statsTree.resetStats();
+	statsTree.remove(1);
+	statsTree.remove(2);
+	statsTree.insert(4);
+	TreeStats removeStats = statsTree.stats();
+	if (insertStats.insertRebalances == 1 && insertStats.leftRotations == 1 && insertStats.rightRotations == 0 && insertStats.removeRebalances == 0 &&
+		insertStats.descents == 4 && insertStats.descentNodes == 5 && insertStats.descentDepths[0] == 1 && insertStats.descentDepths[1] == 1 && insertStats.descentDepths[2] == 2 &&
+		insertStats.comparisons == 5 && insertStats.descentDepthPercentile(0.5) == 1 && insertStats.descentDepthPercentile(0.99) == 2 && insertStats.averageDescentDepth() == 1.25 &&
+		removeStats.removeRebalances == 0 && removeStats.insertRebalances == 0 && removeStats.descents == 3 && removeStats.leftRotations == 0)
+	{
+		cout << "Instrumentation tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+#endif
+
+	AVLMultiset<string> eventIndex;
+	for (const char* event : { "open", "read", "read", "close", "read", "open" })
+		eventIndex.insert(event);
+	long long readCopies = eventIndex.insert("read");
+	bool oneErased = eventIndex.eraseOne("open") && eventIndex.eraseOne("open") && !eventIndex.eraseOne("open") && !eventIndex.eraseOne("write");
+	long long readErased = eventIndex.eraseAll("read");
+	eventIndex.insert("close");
+	if (readCopies == 4 && oneErased && readErased == 4 && eventIndex.eraseAll("read") == 0 && eventIndex.count("close") == 2 && !eventIndex.contains("open") &&
+		eventIndex.distinctCount() == 1 && eventIndex.totalCount() == 2 && eventIndex.begin()->value == "close" && eventIndex.begin()->multiplicity == 2 &&
+		eventIndex.lowerBound("a")->value == "close" && eventIndex.upperBound("close") == eventIndex.end())
+	{
+		cout << "Multiset tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	vector<Record> records(100);
+	IntrusiveAVLTree<Record, RecordIdCompare> recordsById;
+	IntrusiveAVLTree<Record, RecordNameCompare, ByName> recordsByName;
+	for (int i = 0; i < 100; i++)
+	{
+		records[i].id = (i * 37) % 100;
+		records[i].name = "record" + to_string(1000 + i);
+		recordsById.insert(records[i]);
+		recordsByName.insert(records[i]);
+	}
+	Record duplicateRecord;
+	duplicateRecord.id = 5;
+	bool duplicateThrew = false;
+	try
+	{
+		recordsById.insert(duplicateRecord);
+	}
+	catch (DuplicateItemException&)
+	{
+		duplicateThrew = !recordsById.isLinked(duplicateRecord);
+	}
+	for (int i = 0; i < 100; i += 2)
+		recordsById.remove(records[i]);
+	bool unlinkedThrew = false;
+	try
+	{
+		recordsById.remove(records[0]);
+	}
+	catch (ItemNotFoundException&)
+	{
+		unlinkedThrew = true;
+	}
+	bool intrusiveValid = true;
+	try
+	{
+		recordsById.validate();
+		recordsByName.validate();
+	}
+	catch (InvalidTreeException&)
+	{
+		intrusiveValid = false;
+	}
+	//Id 7 is held by record 11, since 11 * 37 = 407.
+	Record* foundRecord = recordsById.find(7);
+	auto nextByName = recordsByName.iteratorTo(records[11]);
+	++nextByName;
+	bool idOrdered = is_sorted(recordsById.begin(), recordsById.end(), [](const Record& item1, const Record& item2) { return item1.id < item2.id; });
+	recordsById.clear();
+	if (duplicateThrew && unlinkedThrew && intrusiveValid && idOrdered && foundRecord == &records[11] && nextByName->name == "record1012" &&
+		!recordsById.isLinked(records[1]) && recordsByName.isLinked(records[0]) && recordsById.count() == 0 && recordsByName.count() == 100 &&
+		recordsByName.begin()->name == "record1000" && prev(recordsByName.end())->name == "record1099" && recordsById.tryInsert(records[3]).second &&
+		recordsById.lowerBound(10)->id == 11 && recordsById.tryRemove(records[3]) == &records[3] && !recordsById.isLinked(records[3]))
+	{
+		cout << "Intrusive tree tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
+
+	bool validTrees = true;
+	BinarySearchTree<int> churnedTree;
+	for (int i = 0; i < 2000; i++)
+	{
+		churnedTree.tryInsert((i * 7919) % 1000);
+		if (i % 3 == 0)
+			churnedTree.tryRemove((i * 104729) % 1000);
+	}
+	try
+	{
+		testTree1.validate();
+		testTree2.validate();
+		testTree3.validate();
+		testTree4.validate();
+		testTree5.validate();
+		testTree6.validate();
+		testTree7.validate();
+		testTree8.validate();
+		churnedTree.validate();
+		BinarySearchTree<int, ThreeWayCompare<int>, allocator<int>, true>(churnedTree.begin(), churnedTree.end()).validate();
+	}
+	catch (InvalidTreeException&)
+	{
+		validTrees = false;
+	}
+	if (validTrees)
+	{
+		cout << "Validate tests passed" << endl << endl;
+	}
+	else
+		failedTests++;
 
 	cout << "All Tests Complete. Passed tests are above." << endl;
-	return 0;
-}
\ No newline at end of file
+	if (failedTests)
+		cout << failedTests << " tests failed." << endl;
+	return failedTests ? 1 : 0;
+}